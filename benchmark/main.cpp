@@ -25,6 +25,8 @@
 #include "monitaal/state.h"
 #include "monitaal/Monitor.h"
 #include "monitaal/EventParser.h"
+#include "monitaal/BinaryTrace.h"
+#include "monitaal/ModelArtifact.h"
 
 #include "gear_controller_model.h"
 #include "b_live_a_freq.h"
@@ -48,7 +50,7 @@ struct benchmark_setting {
     symb_time_t actual_latency_o = 0, actual_latency_i = 0;
     int error = 0;
     symb_time_t jitter = 0;
-    std::vector<std::string> div_alphabet = {};
+    bool time_divergence = false;
     int uncertainty_val = 0;
 };
 
@@ -59,13 +61,8 @@ void b_live_a_freq_concrete(benchmark_setting& setting) {
     TA pos = Parser::parse_data(b_live_a_freq_model, "positive");
     TA neg = Parser::parse_data(b_live_a_freq_model, "negative");
 
-    if (setting.div_alphabet.size() > 0) {
-        auto div = TA::time_divergence_ta(setting.div_alphabet, true);
-        pos.intersection(div);
-        neg.intersection(div);
-    }
-
     settings_t monitor_setting(setting.inclusion, setting.inclusion, setting.latency, setting.jitter);
+    monitor_setting.time_divergence = setting.time_divergence;
 
     Concrete_monitor monitor(pos, neg, monitor_setting);
     
@@ -108,13 +105,8 @@ void b_live_a_freq_interval(benchmark_setting& setting) {
     TA pos = Parser::parse_data(b_live_a_freq_model, "positive");
     TA neg = Parser::parse_data(b_live_a_freq_model, "negative");
 
-    if (setting.div_alphabet.size() > 0) {
-        auto div = TA::time_divergence_ta(setting.div_alphabet, true);
-        pos.intersection(div);
-        neg.intersection(div);
-    }
-
     settings_t monitor_setting(setting.inclusion, setting.inclusion, setting.latency, setting.jitter);
+    monitor_setting.time_divergence = setting.time_divergence;
 
     Interval_monitor monitor(pos, neg, monitor_setting);
     bool overlap = true;
@@ -170,13 +162,8 @@ void b_live_a_freq_test(benchmark_setting& setting) {
     TA pos = Parser::parse_data(b_live_a_freq_model, "positive");
     TA neg = Parser::parse_data(b_live_a_freq_model, "negative");
 
-    if (setting.div_alphabet.size() > 0) {
-        auto div = TA::time_divergence_ta(setting.div_alphabet, true);
-        pos.intersection(div);
-        neg.intersection(div);
-    }
-
     settings_t monitor_setting(setting.inclusion, setting.inclusion, setting.latency, setting.jitter);
+    monitor_setting.time_divergence = setting.time_divergence;
     monitor_setting.latency_i = setting.latency_i;
     monitor_setting.jitter_i = setting.jitter;
 
@@ -245,60 +232,38 @@ void b_live_a_freq_test(benchmark_setting& setting) {
 
 void run_gearcontroller(benchmark_setting& setting) {
     settings_t monitor_setting{setting.inclusion, setting.inclusion, setting.latency, setting.jitter};
+    monitor_setting.time_divergence = setting.time_divergence;
 
 
-    TA CloseClutch = Parser::parse_data(gear_controller_properties, "CloseClutch");
-    TA OpenClutch = Parser::parse_data(gear_controller_properties, "OpenClutch");
-    TA ReqSet = Parser::parse_data(gear_controller_properties, "ReqSet");
-    TA ReqNeu = Parser::parse_data(gear_controller_properties, "ReqNeu");
-    TA SpeedSet = Parser::parse_data(gear_controller_properties, "SpeedSet");
-    TA test1 = Parser::parse_data(gear_controller_properties, "test1");
-    TA NotCloseClutch = Parser::parse_data(gear_controller_properties, "NotCloseClutch");
-    TA NotOpenClutch = Parser::parse_data(gear_controller_properties, "NotOpenClutch");
-    TA NotReqSet = Parser::parse_data(gear_controller_properties, "NotReqSet");
-    TA NotReqNeu = Parser::parse_data(gear_controller_properties, "NotReqNeu");
-    TA NotSpeedSet = Parser::parse_data(gear_controller_properties, "NotSpeedSet");
-    TA Nottest1 = Parser::parse_data(gear_controller_properties, "Nottest1");
-
-    if (setting.div_alphabet.size() > 0) {
-        auto div = TA::time_divergence_ta(setting.div_alphabet, true);
-        CloseClutch.intersection(div);
-        OpenClutch.intersection(div);
-        ReqSet.intersection(div);
-        ReqNeu.intersection(div);
-        SpeedSet.intersection(div);
-        test1.intersection(div);
-        NotCloseClutch.intersection(div);
-        NotOpenClutch.intersection(div);
-        NotReqSet.intersection(div);
-        NotReqNeu.intersection(div);
-        NotSpeedSet.intersection(div);
-        Nottest1.intersection(div);
-    }
+    // One parse of the property suite, each property is paired with its negation (X and NotX)
+    auto properties = Parser::pair_properties(Parser::parse_all_data(gear_controller_properties));
 
-    std::vector<Delay_monitor> monitors = {
-        Delay_monitor(CloseClutch, NotCloseClutch, monitor_setting),
-        Delay_monitor(OpenClutch, NotOpenClutch, monitor_setting),
-        Delay_monitor(ReqSet, NotReqSet, monitor_setting),
-        Delay_monitor(ReqNeu, NotReqNeu, monitor_setting),
-        Delay_monitor(SpeedSet, NotSpeedSet, monitor_setting),
-        Delay_monitor(test1, Nottest1, monitor_setting)
-    };
+    std::vector<Delay_monitor> monitors;
+    for (const auto& name : {"CloseClutch", "OpenClutch", "ReqSet", "ReqNeu", "SpeedSet", "test1"}) {
+        const auto& [pos, neg] = properties.at(name);
+        monitors.push_back(Delay_monitor(pos, neg, monitor_setting));
+    }
 
     auto size = 6;
     bool is_firm = false;
     int event_counter = 0;
 
+    // The monitors report their verdicts, so the bank is firm without checking every monitor after every event
+    std::vector<std::pair<int, verdict_change_t>> verdicts;
+    for (int i = 0; i < size; ++i)
+        monitors[i].subscribe([&verdicts, i](const verdict_change_t& change) { verdicts.emplace_back(i, change); });
+
     int tmp = 0;
     int max_states = 0;
     int max_response_time = 0;
     int response_time = 0;
     int time_horizon = 0;
 
-    std::stringstream input_stream(gear_controller_input, std::ios::in);
+    std::string_view input(gear_controller_input);
+    MappedEventParser parser(input.data(), input.size());
+    auto next_event = parser.begin();
 
-    std::vector<timed_input_t> events;
-    std::vector<timed_input_t> tmpevents;
+    event_t event;
 
     auto t1 = std::chrono::high_resolution_clock::now();
     auto t2 = std::chrono::high_resolution_clock::now();
@@ -307,17 +272,14 @@ void run_gearcontroller(benchmark_setting& setting) {
     while ((not is_firm) && (setting.trace_bound == 0 || event_counter < setting.trace_bound)) {
 
         
-        tmpevents = EventParser::parse_input(&input_stream, 1);
-        events.clear();
-
-        if (tmpevents.size() == 0) break;
-        for (auto &e : tmpevents) {
-            events.push_back(timed_input_t({e.time.first - setting.uncertainty_val, e.time.second + setting.uncertainty_val}, e.label, e.type));
-        }
+        if (next_event == parser.end()) break;
+        event = *next_event;
+        event.time = {event.time.first - setting.uncertainty_val, event.time.second + setting.uncertainty_val};
+        ++next_event;
         
         t1 = std::chrono::high_resolution_clock::now();
         for (int i = 0; i < size; ++i) {
-            monitors[i].input(events);
+            monitors[i].input(event);
         }
         t2 = std::chrono::high_resolution_clock::now();
         
@@ -337,8 +299,9 @@ void run_gearcontroller(benchmark_setting& setting) {
 
         max_states = tmp > max_states ? tmp : max_states;
         
-        event_counter += events.size();
-        time_horizon = events[events.size()-1].time.second;
+        ++event_counter;
+        time_horizon = event.time.second;
+        is_firm = verdicts.size() == static_cast<size_t>(size);
     }
     std::cout << "Monitored " << event_counter << " events in " << time.count() << 
                  "ns\nMax states: "<< max_states << "\nmax response: "<< max_response_time << "ns\nTime Horizon: " << time_horizon <<"\nMemory: " << sizeof(monitors) <<"\nMonitor verdicts are\n";
@@ -346,11 +309,15 @@ void run_gearcontroller(benchmark_setting& setting) {
         std::cout << monitors[i].status() << ", ";
     }
     std::cout << '\n';
+    for (const auto& [i, change] : verdicts)
+        std::cout << "Monitor " << i << " is " << change.verdict << " at event " << change.event << " (time "
+                  << change.time.first << ")\n";
 }
 
 
 void run_gearcontroller_testing(benchmark_setting& setting, bool testing) {
     settings_t monitor_setting{setting.inclusion, setting.inclusion, setting.latency, setting.jitter};
+    monitor_setting.time_divergence = setting.time_divergence;
     
     monitor_setting.latency_i = setting.latency_i;
     monitor_setting.jitter_i = setting.jitter;
@@ -358,12 +325,6 @@ void run_gearcontroller_testing(benchmark_setting& setting, bool testing) {
     TA pos = Parser::parse_data(gear_controller_test_model, "positive");
     TA neg = Parser::parse_data(gear_controller_test_model, "negative");
 
-    if (setting.div_alphabet.size() > 0) {
-        auto div = TA::time_divergence_ta({"ReqNewGear", "NewGear"}, true);
-        pos.intersection(div);
-        neg.intersection(div);
-    }
-
     auto monitor_test = Testing_monitor(pos, neg, monitor_setting);
     auto monitor = Delay_monitor(pos, neg, monitor_setting);
 
@@ -641,15 +602,8 @@ std::vector<timed_input_t> simulate_gear_controller_classic(const benchmark_sett
 void gear_controller_sim_bench(const benchmark_setting& setting) {
     auto prop = gear_control_newgear_prop();
 
-    auto labels = prop.first.labels();
-
-    if (setting.div_alphabet.size() > 0) {
-        TA div = TA::time_divergence_ta(std::vector<label_t>(labels.begin(), labels.end()), true);
-        prop.first.intersection(div);
-        prop.second.intersection(div);
-    }
-
     settings_t monitor_setting(setting.inclusion, setting.inclusion, setting.latency, setting.jitter);
+    monitor_setting.time_divergence = setting.time_divergence;
 
     Interval_monitor monitor(prop.first, prop.second, monitor_setting);
 
@@ -709,6 +663,37 @@ void gear_controller_sim_bench(const benchmark_setting& setting) {
                 //  "ns\nVerdict: " << monitor.status() << "\nMax states: "<< max_states << "\nmax response: "<< max_response_time << "ns\nMemory: " << sizeof(monitor) << '\n';
 }
 
+template<class events_t>
+int replay_events(Interval_monitor& monitor, const benchmark_setting& setting, events_t&& events) {
+    int count = 0;
+    for (auto it = events.begin(); it != events.end() && monitor.status() == INCONCLUSIVE; ++it) {
+        monitor.input(*it);
+        if (++count == setting.trace_bound)
+            break;
+    }
+    return count;
+}
+
+// Replays a recorded trace (text or binary) on a compiled model. The time includes reading the trace
+void replay(const benchmark_setting& setting, const std::string& model, const std::string& trace) {
+    auto artifact = ModelArtifact::load(model);
+
+    settings_t monitor_setting;
+    monitor_setting.inclusion = setting.inclusion;
+    monitor_setting.clock_abstraction = setting.inclusion;
+    Interval_monitor monitor(artifact, monitor_setting);
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    int count = BinaryTraceReader::is_binary_trace(trace) ? replay_events(monitor, setting, BinaryTraceReader(trace))
+                                                          : replay_events(monitor, setting, MappedEventParser(trace));
+    auto t2 = std::chrono::high_resolution_clock::now();
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1);
+
+    std::cout << "Monitored " << count << " events in " << time.count() << "ns\n"
+              << "Events per second: " << (time.count() > 0 ? count * 1e9 / time.count() : 0) << '\n'
+              << "Verdict: " << monitor.status() << '\n';
+}
+
 int main(int argc, const char** argv) {
 
     po::options_description options;
@@ -717,7 +702,7 @@ int main(int argc, const char** argv) {
             ("length", po::value<int>()->default_value(0, "0"), "Bound on the number of observations. 0 means no bound")
             ("inclusion", "Enable inclusion and inactive clock abstraction")
             ("uncertainty", po::value<symb_time_t>()->default_value(0, "0"), "Random timing uncertainty added to observations")
-            ("div,d", po::value<std::vector<std::string>>()->multitoken()->default_value({}, "Empty"), "<list of labels> : Take time divergence into account.")
+            ("div,d", po::value<std::vector<std::string>>()->multitoken()->zero_tokens(), "Take time divergence into account. A list of labels is accepted for compatibility, but not needed.")
             ("latency", po::value<std::vector<symb_time_t>>()->multitoken()->default_value({0, 0}, "0 0"), "Specify latency upper and lower bound parameters")
             ("actual-latency", po::value<symb_time_t>()->default_value(0, "0"), "Latency used to shift outputs")
             ("actual-latency-i", po::value<symb_time_t>()->default_value(0, "0"), "Latency used to shift inputs")
@@ -731,7 +716,8 @@ int main(int argc, const char** argv) {
             ("seed", po::value<std::time_t>(), "Provide a seed for randomness, default is time")
             ("b-live-a-freq-con","Run the b-liveness & a-frequency benchmark with concrete time")
             ("b-live-a-freq-test","Run the b-liveness & a-frequency benchmark under test")
-            ("gear-controller-sim-bench", "Monitor a complex property over a simulation of the gear controller");
+            ("gear-controller-sim-bench", "Monitor a complex property over a simulation of the gear controller")
+            ("replay", po::value<std::vector<std::string>>()->multitoken(), "<model> <trace> : Replay a text or binary trace on a model compiled with monitaal-compile");
 
     po::variables_map vm;
     po::store(po::command_line_parser(argc, argv).options(options).run(), vm);
@@ -765,7 +751,7 @@ int main(int argc, const char** argv) {
     setting.latency = {latency[0], latency[1]};
     setting.actual_latency_o = vm["actual-latency"].as<symb_time_t>();
     setting.actual_latency_i = vm["actual-latency-i"].as<symb_time_t>();
-    setting.div_alphabet = vm["div"].as<std::vector<std::string>>();
+    setting.time_divergence = vm.count("div") > 0;
     setting.uncertainty_val = vm["uncertainty"].as<symb_time_t>();
     setting.latency_i = {latency_i[0], latency_i[1]};
     setting.error = vm["error"].as<int>();
@@ -789,6 +775,19 @@ int main(int argc, const char** argv) {
         b_live_a_freq_test(setting);
     if (vm.count("gear-controller-sim-bench"))
         gear_controller_sim_bench(setting);
+    if (vm.count("replay")) {
+        auto replayarg = vm["replay"].as<std::vector<std::string>>();
+        if (replayarg.size() != 2) {
+            std::cerr << "Error: --replay requires two arguments (model and trace)\n";
+            exit(-1);
+        }
+        try {
+            replay(setting, replayarg[0], replayarg[1]);
+        } catch (const base_error& e) {
+            std::cerr << e.what() << '\n';
+            exit(-1);
+        }
+    }
 
     return 0;
 }
@@ -25,13 +25,25 @@
 #include "monitaal/state.h"
 #include "monitaal/Monitor.h"
 #include "monitaal/EventParser.h"
+#include "monitaal/EventMerger.h"
+#include "monitaal/SessionManager.h"
+#include "monitaal/BinaryTrace.h"
+#include "monitaal/UppaalTrace.h"
+#include "monitaal/ReorderBuffer.h"
+#include "monitaal/SPSCRing.h"
+#include "monitaal/ModelArtifact.h"
 #include "errors.h"
 
 #include <boost/program_options.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <chrono>
+#include <exception>
+#include <optional>
+#include <thread>
 
 #include <time.h>
 #include <chrono>
@@ -49,7 +61,16 @@ struct bin_settings_t
 {
     bool verbose = false;
     bool silent = false;
-    uint32_t event_counter = 0;
+    bool pipeline = false; // Parse in a separate thread
+    size_t threads = 1;    // Threads parsing a text trace file
+    std::string uppaal_model; // The input is an UPPAAL trace of this model if not empty
+    std::vector<size_t> tie_break; // Order of the inputs for events at equal times
+    std::optional<reorder_window_t> reorder; // Sort each input that is slightly out of order
+    std::optional<session_settings_t> sessions; // Monitor each #session of the input separately
+    std::string checkpoint; // Write checkpoints of the monitor to this file if not empty
+    uint64_t checkpoint_every = 100000; // Events between checkpoints
+    uint64_t restored = 0; // Events of the input that were monitored before the monitor was restored
+    uint64_t event_counter = 0;
     TA positive, negative;
 
     bin_settings_t(const TA& positive, const TA& negative) : positive(positive), negative(negative) {};
@@ -108,20 +129,204 @@ template void interactive_monitoring<concrete_state_t>(Monitor<concrete_state_t>
 template void interactive_monitoring<symbolic_state_t>(Monitor<symbolic_state_t>& monitor, bin_settings_t& settings, std::ostream& out, std::istream& in);
 template void interactive_monitoring<delay_state_t>(Monitor<delay_state_t>& monitor, bin_settings_t& settings, std::ostream& out, std::istream& in);
 
-template <class state_t>
-void monitor_from_file(Monitor<state_t>& monitor, bin_settings_t& settings, std::ostream& out, std::istream& input) {
-    std::vector<timed_input_t> events;
+// The events in a ring as an input range. Advancing pops the next event, and the end is reached once the ring is
+// closed and drained
+struct ring_events_t {
+    SPSCRing<event_t>& ring;
 
-    while (not input.eof() || monitor.status() == INCONCLUSIVE) {        
-        events = EventParser::parse_input(&input, 1000);
-        monitor.input(events);
-        settings.event_counter += events.size();
+    struct iterator {
+        SPSCRing<event_t>* ring = nullptr;
+        event_t event;
+
+        const event_t& operator*() const { return event; }
+        iterator& operator++() {
+            if (not ring->pop(event))
+                ring = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return ring == other.ring; }
+    };
+
+    iterator begin() { return ++iterator{&ring}; }
+    iterator end() { return {}; }
+};
+
+// The parser thread fills a ring of parsed events which the monitor drains. A full ring stalls the parser, and the
+// ring is closed when the verdict is final such that the parser stops early
+template <class state_t, class events_t>
+void monitor_pipelined(Monitor<state_t>& monitor, bin_settings_t& settings, events_t& events) {
+    SPSCRing<event_t> ring(4096);
+    std::exception_ptr error;
+
+    std::thread parser([&ring, &events, &error]() {
+        try {
+            for (const auto& event : events)
+                if (not ring.push(event))
+                    break;
+        } catch (...) {
+            error = std::current_exception();
+        }
+        ring.close();
+    });
+
+    ring_events_t parsed{ring};
+    settings.event_counter += monitor.input_coalesced(parsed.begin(), parsed.end());
+    ring.close();
+    parser.join();
+
+    // As in one pass, errors after the verdict are not reported
+    if (error && monitor.status() == INCONCLUSIVE)
+        std::rethrow_exception(error);
+}
+
+// Skips the events that were monitored before the checkpoint was written and writes a checkpoint every
+// checkpoint_every events and once monitoring ends. Events are monitored one at a time
+template <class state_t, class events_t>
+void monitor_checkpointed(Monitor<state_t>& monitor, bin_settings_t& settings, events_t& events) {
+    auto first = events.begin();
+    auto last = events.end();
+
+    for (uint64_t skipped = 0; skipped < settings.restored && first != last; ++skipped)
+        ++first;
+
+    // The iterator is not advanced past the deciding event, so no more events are read once the verdict is final
+    for (; first != last; ++first) {
+        monitor.input(*first);
+        ++settings.event_counter;
+        if (not settings.checkpoint.empty() && settings.event_counter % settings.checkpoint_every == 0)
+            monitor.checkpoint(settings.checkpoint, settings.event_counter);
+        if (monitor.status() != INCONCLUSIVE)
+            break;
+    }
+
+    if (not settings.checkpoint.empty())
+        monitor.checkpoint(settings.checkpoint, settings.event_counter);
+}
+
+// Parsing and monitoring is one pass. No more events are read once the verdict is final. Runs of events that the
+// monitor does not observe are monitored as one delay, which gives the same verdict and event count
+template <class state_t, class events_t>
+void monitor_events(Monitor<state_t>& monitor, bin_settings_t& settings, events_t& events) {
+    if (monitor.status() != INCONCLUSIVE)
+        return;
+
+    if (not settings.checkpoint.empty() || settings.restored > 0) {
+        monitor_checkpointed(monitor, settings, events);
+        return;
+    }
+
+    if (settings.pipeline) {
+        monitor_pipelined(monitor, settings, events);
+        return;
+    }
+
+    settings.event_counter += monitor.input_coalesced(events.begin(), events.end());
+}
+
+// Passes the events to f, sorted by a reorder buffer if a reorder window is given. Late events are reported and dropped
+template <class range_t, class F>
+void reorder_input(const bin_settings_t& settings, std::shared_ptr<range_t> events, const std::string& path, F&& f) {
+    if (not settings.reorder) {
+        f(std::move(events));
+        return;
     }
+
+    auto sorted = std::make_shared<ReorderBuffer>(std::move(events), *settings.reorder);
+    sorted->set_late_handler([&settings, path](const event_t& event) {
+        if (not settings.silent)
+            std::cerr << "Warning: Dropped an event of " << path << " at " << event.time.first
+                      << " that arrived later than the reorder window\n";
+    });
+    f(std::move(sorted));
+}
+
+// Opens the input at path with the reader for its format and passes it to f. Labels that neither automaton observes
+// are dropped while parsing, only their time is kept. Each input is sorted on its own before inputs are merged
+template <class F>
+void open_input(const bin_settings_t& settings, const PerfectHash& alphabet, const std::string& path, F&& f) {
+    if (settings.sessions && (not settings.uppaal_model.empty() || BinaryTraceReader::is_binary_trace(path)))
+        throw base_error("Error: ", path, " has no session keys, so it cannot be monitored with --sessions");
+
+    if (not settings.uppaal_model.empty()) {
+        auto events = std::make_shared<UppaalTraceReader>(settings.uppaal_model, path);
+        events->set_alphabet(alphabet);
+        reorder_input(settings, std::move(events), path, f);
+    } else if (path == "-") {
+        auto events = std::make_shared<StreamEventParser>(std::cin);
+        events->set_alphabet(alphabet);
+        events->set_sessions(settings.sessions.has_value());
+        reorder_input(settings, std::move(events), path, f);
+    } else if (BinaryTraceReader::is_binary_trace(path)) {
+        auto events = std::make_shared<BinaryTraceReader>(path);
+        events->set_alphabet(alphabet);
+        reorder_input(settings, std::move(events), path, f);
+    } else if (settings.threads != 1) {
+        auto events = std::make_shared<ParallelEventParser>(path, settings.threads);
+        events->set_alphabet(alphabet);
+        events->set_sessions(settings.sessions.has_value());
+        reorder_input(settings, std::move(events), path, f);
+    } else {
+        auto events = std::make_shared<MappedEventParser>(path);
+        events->set_alphabet(alphabet);
+        events->set_sessions(settings.sessions.has_value());
+        reorder_input(settings, std::move(events), path, f);
+    }
+}
+
+// Passes the events of the inputs to f. Several inputs, each ordered by time, are merged into one timed word
+template <class F>
+void with_inputs(const bin_settings_t& settings, const std::vector<std::string>& paths, F&& f) {
+    std::vector<std::string> labels(settings.positive.labels().begin(), settings.positive.labels().end());
+    labels.insert(labels.end(), settings.negative.labels().begin(), settings.negative.labels().end());
+    PerfectHash alphabet(std::move(labels));
+
+    if (paths.size() == 1) {
+        open_input(settings, alphabet, paths[0], [&](auto events) { f(*events); });
+        return;
+    }
+
+    if (std::count(paths.begin(), paths.end(), "-") > 1)
+        throw base_error("Error: Standard input can only be given once");
+
+    EventMerger merger;
+    for (const auto& path : paths)
+        open_input(settings, alphabet, path, [&](auto events) { merger.add(std::move(events), path); });
+    if (not settings.tie_break.empty())
+        merger.set_tie_break(settings.tie_break);
+    f(merger);
+}
+
+template <class state_t>
+void monitor_from_files(Monitor<state_t>& monitor, bin_settings_t& settings, const std::vector<std::string>& paths) {
+    with_inputs(settings, paths, [&](auto& events) { monitor_events(monitor, settings, events); });
 }
 
-template void monitor_from_file<concrete_state_t>(Monitor<concrete_state_t>& monitor, bin_settings_t& settings, std::ostream& out, std::istream& input);
-template void monitor_from_file<symbolic_state_t>(Monitor<symbolic_state_t>& monitor, bin_settings_t& settings, std::ostream& out, std::istream& input);
-template void monitor_from_file<delay_state_t>(Monitor<delay_state_t>& monitor, bin_settings_t& settings, std::ostream& out, std::istream& input);
+// Each #session key in the input is monitored separately. A line is printed per session when it is evicted
+template <class state_t>
+void monitor_sessions(const ModelArtifact& artifact, const settings_t& monitor_setting, bin_settings_t& settings,
+                      const std::vector<std::string>& paths) {
+    size_t sessions = 0;
+    SessionManager<state_t> manager(artifact.positive_property(), artifact.negative_property(), monitor_setting,
+                                    *settings.sessions,
+            [&settings, &sessions](std::string_view session, monitor_answer_e verdict, session_end_e reason, const auto&) {
+                ++sessions;
+                if (not settings.silent)
+                    std::cout << "Session " << session << ": " << verdict << " (" << reason << ")\n";
+            });
+
+    // The labels of queued events view the inputs, so the sessions are finished while the inputs are open
+    with_inputs(settings, paths, [&](auto& events) {
+        for (const auto& event : events) {
+            manager.input(event);
+            ++settings.event_counter;
+        }
+        manager.finish();
+    });
+
+    if (not settings.silent)
+        std::cout << "Monitored " << settings.event_counter << " events in " << sessions << " sessions, "
+                  << manager.finished_sessions() << " with a final verdict\n";
+}
 
 bool arg_type(const po::variables_map& vm) {
     if (vm.count("type")) {
@@ -146,20 +351,36 @@ void print_dot(const TA& pos, const TA& neg, std::ostream& out) {
 }
 
 int main(int argc, const char** argv) {
+    // The C++ streams are not used together with C stdio. Synchronized streams read standard input one locked
+    // character at a time, which is slow once the parser runs in its own thread
+    std::ios::sync_with_stdio(false);
 
     po::options_description options;
     options.add_options()
             ("help,h", "Dispay this help message\nExample: monitaal-bin --pos <name> <path> --neg <name> <path>")
-            ("pos,p", po::value<std::vector<std::string>>()->required()->multitoken(), "<name of template> <path to xml file> : Property automaton.")
-            ("neg,n", po::value<std::vector<std::string>>()->required()->multitoken(), "<name of template> <path to xml file> : Negated property automaton.")
+            ("pos,p", po::value<std::vector<std::string>>()->multitoken(), "<name of template> <path to xml file> : Property automaton.")
+            ("neg,n", po::value<std::vector<std::string>>()->multitoken(), "<name of template> <path to xml file> : Negated property automaton.")
+            ("model,m", po::value<std::string>(), "<path> : Compiled model from monitaal-compile (instead of --pos and --neg).")
             ("type,t", po::value<std::string>()->default_value("concrete", "concrete"), "Input type (concrete or interval) default = concrete.")
-            ("input,i", po::value<std::string>(), "Monitor events contained in file.")
+            ("input,i", po::value<std::vector<std::string>>()->multitoken(), "Monitor events contained in files, text or binary traces ('-' for standard input). Several inputs, each ordered by time, are merged by time.")
+            ("sessions,S", po::value<size_t>(), "<n> : Events carry a #session key and each session is monitored separately, by n worker threads (0 for the main thread).")
+            ("idle", po::value<symb_time_t>(), "<time> : Evict a session after this much time without events (with --sessions).")
+            ("deadlines", "Decide the verdict of a silent session at its deadline, once the input has passed it (with --sessions). The input must be ordered by time.")
+            ("tie-break,b", po::value<std::vector<size_t>>()->multitoken(), "<i j ...> : Events at equal times are taken from the inputs in this order (0 is the first input). Default is the order of --input.")
+            ("checkpoint,k", po::value<std::string>(), "<path> : Periodically write a checkpoint of the monitor to this file, and once monitoring ends.")
+            ("checkpoint-every", po::value<uint64_t>()->default_value(100000), "<n> : Events between checkpoints (with --checkpoint).")
+            ("restore,r", po::value<std::string>(), "<path> : Continue from a checkpoint. The events of the input that were monitored before the checkpoint are skipped.")
+            ("reorder,R", po::value<symb_time_t>(), "<time> : Sort inputs that are out of order by up to this much time. Events that arrive later are dropped with a warning.")
+            ("reorder-events", po::value<size_t>(), "<n> : Sort inputs that are out of order by up to n events (with or instead of --reorder).")
+            ("pipeline,P", "Parse the input in a separate thread, pipelined with monitoring.")
+            ("uppaal-model,U", po::value<std::string>(), "<path> : The input is an UPPAAL simulation trace (JSON) of this model.")
+            ("threads,j", po::value<size_t>()->default_value(1), "<n> : Parse a text trace file in chunks with n threads (0 for one per core).")
             ("inclusion,u", "Enable inclusion checking for duplicate states")
             ("clock-abstraction,c", "Enable abstraction of inactive clocks (Automatically enables inclusion)")
             ("verbose,v", "Prints more information on the monitoring procedure.")
             ("silent,s", "removes all outputs")
             ("print-dot,o", "Prints the dot graphs of the given automata.")
-            ("div,d", po::value<std::vector<std::string>>()->multitoken(), "<list of labels> : Take time divergence into account.");
+            ("div,d", po::value<std::vector<std::string>>()->multitoken()->zero_tokens(), "Take time divergence into account. A list of labels is accepted for compatibility, but not needed.");
 
     po::variables_map vm;
     po::store(po::command_line_parser(argc, argv).options(options).run(), vm);
@@ -177,18 +398,48 @@ int main(int argc, const char** argv) {
         exit(-1);
     }
 
-    auto posarg = vm["pos"].as<std::vector<std::string>>();
-    auto negarg = vm["neg"].as<std::vector<std::string>>();
+    std::optional<ModelArtifact> artifact;
+
+    try {
+        if (vm.count("model")) {
+            if (vm.count("pos") || vm.count("neg")) {
+                std::cerr << "Error: --model cannot be combined with --pos and --neg\n";
+                exit(-1);
+            }
+
+            artifact.emplace(ModelArtifact::load(vm["model"].as<std::string>()));
 
-    if (posarg.size() != 2 || negarg.size() != 2) {
-        for (int i = 0; i < posarg.size(); ++i)
-            std::cout << posarg[i];
-        std::cerr << "Error: --pos and --neg args require two arguments\n";
+            if (vm.count("div") && not artifact->time_divergence()) {
+                std::cerr << "Error: The model is compiled without time divergence, compile it again with --div\n";
+                exit(-1);
+            }
+        } else {
+            if (not vm.count("pos") || not vm.count("neg")) {
+                std::cerr << "Error: Some required fields not given\n";
+                exit(-1);
+            }
+
+            auto posarg = vm["pos"].as<std::vector<std::string>>();
+            auto negarg = vm["neg"].as<std::vector<std::string>>();
+
+            if (posarg.size() != 2 || negarg.size() != 2) {
+                for (int i = 0; i < posarg.size(); ++i)
+                    std::cout << posarg[i];
+                std::cerr << "Error: --pos and --neg args require two arguments\n";
+                exit(-1);
+            }
+
+            // The accepting spaces are computed once and shared by the interval and concrete monitor
+            artifact.emplace(Parser::parse_file(&posarg[1][0], &posarg[0][0]),
+                             Parser::parse_file(&negarg[1][0], &negarg[0][0]), vm.count("div") > 0);
+        }
+    } catch (const base_error& e) {
+        std::cerr << e.what() << '\n';
         exit(-1);
     }
 
-    TA pos = Parser::parse_file(&posarg[1][0], &posarg[0][0]);
-    TA neg = Parser::parse_file(&negarg[1][0], &negarg[0][0]);
+    const TA& pos = artifact->positive();
+    const TA& neg = artifact->negative();
 
     bool is_interval = arg_type(vm);
 
@@ -197,45 +448,80 @@ int main(int argc, const char** argv) {
         print_dot(pos, neg, std::cout);
     }
 
-    // Handle time divergence
-    if (vm.count("div")) {
-        auto alphabet = vm["div"].as<std::vector<std::string>>();
-        TA div = TA::time_divergence_ta(alphabet, true);
-        pos.intersection(div);
-        neg.intersection(div);
-
-        if (vm.count("print-dot")) {
-            std::cout << "DOT GRAPHS with time divergence conjunction\n";
-            print_dot(pos, neg, std::cout);
-        }
-
-    }
-
     bin_settings_t settings(pos, neg);
     settings.verbose = vm.count("verbose") > 0;
     settings.silent = vm.count("silent") > 0;
+    settings.pipeline = vm.count("pipeline") > 0;
+    settings.threads = vm["threads"].as<size_t>();
+    if (vm.count("uppaal-model"))
+        settings.uppaal_model = vm["uppaal-model"].as<std::string>();
+    if (vm.count("tie-break"))
+        settings.tie_break = vm["tie-break"].as<std::vector<size_t>>();
+    if (vm.count("reorder") || vm.count("reorder-events")) {
+        settings.reorder.emplace();
+        if (vm.count("reorder"))
+            settings.reorder->time = vm["reorder"].as<symb_time_t>();
+        if (vm.count("reorder-events"))
+            settings.reorder->count = std::max<size_t>(1, vm["reorder-events"].as<size_t>());
+    }
+    if (vm.count("sessions")) {
+        settings.sessions.emplace();
+        settings.sessions->shards = vm["sessions"].as<size_t>();
+        if (vm.count("idle"))
+            settings.sessions->idle_timeout = vm["idle"].as<symb_time_t>();
+        settings.sessions->deadlines = vm.count("deadlines");
+    }
 
     settings_t mon_setting = settings_t();
     mon_setting.inclusion = vm.count("inclusion");
     mon_setting.clock_abstraction = vm.count("clock-abstraction");
+    mon_setting.time_divergence = artifact->time_divergence();
 
-    Interval_monitor monitor_int(pos, neg, mon_setting);
-    Concrete_monitor monitor_con(pos, neg, mon_setting);
+    Interval_monitor monitor_int(*artifact, mon_setting);
+    Concrete_monitor monitor_con(*artifact, mon_setting);
+
+    if (vm.count("checkpoint")) {
+        settings.checkpoint = vm["checkpoint"].as<std::string>();
+        settings.checkpoint_every = std::max<uint64_t>(1, vm["checkpoint-every"].as<uint64_t>());
+    }
+    if ((vm.count("checkpoint") || vm.count("restore")) && (settings.sessions || not vm.count("input"))) {
+        std::cerr << "Error: --checkpoint and --restore require --input and cannot be combined with --sessions\n";
+        exit(-1);
+    }
+    if (vm.count("restore")) {
+        try {
+            if (is_interval)
+                settings.restored = monitor_int.restore(vm["restore"].as<std::string>());
+            else
+                settings.restored = monitor_con.restore(vm["restore"].as<std::string>());
+        } catch (const base_error& e) {
+            std::cerr << e.what() << '\n';
+            exit(-1);
+        }
+        settings.event_counter = settings.restored;
+    }
 
     // Monitoring events from file
     if (vm.count("input")) {
-        auto inputarg = vm["input"].as<std::string>();
-        
-        std::filebuf fb;
-        fb.open(inputarg, std::ios::in);
-        std::istream stream(&fb);
-
-        if (is_interval)
-            monitor_from_file<symbolic_state_t>(monitor_int, settings, std::cout, stream);
-        else
-            monitor_from_file<concrete_state_t>(monitor_con, settings, std::cout, stream);
+        auto inputarg = vm["input"].as<std::vector<std::string>>();
+
+        try {
+            if (settings.sessions) {
+                if (is_interval)
+                    monitor_sessions<symbolic_state_t>(*artifact, mon_setting, settings, inputarg);
+                else
+                    monitor_sessions<concrete_state_t>(*artifact, mon_setting, settings, inputarg);
+                return 0;
+            }
 
-        fb.close();
+            if (is_interval)
+                monitor_from_files<symbolic_state_t>(monitor_int, settings, inputarg);
+            else
+                monitor_from_files<concrete_state_t>(monitor_con, settings, inputarg);
+        } catch (const base_error& e) {
+            std::cerr << e.what() << '\n';
+            exit(-1);
+        }
     }
     else {
         // Interactive Monitoring
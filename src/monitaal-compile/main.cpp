@@ -0,0 +1,84 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "monitaal/Parser.h"
+#include "monitaal/ModelArtifact.h"
+#include "errors.h"
+
+#include <boost/program_options.hpp>
+#include <iostream>
+
+namespace po = boost::program_options;
+using namespace monitaal;
+
+int main(int argc, const char** argv) {
+
+    po::options_description options;
+    options.add_options()
+            ("help,h", "Dispay this help message\nExample: monitaal-compile --pos <name> <path> --neg <name> <path> --output <path>")
+            ("pos,p", po::value<std::vector<std::string>>()->required()->multitoken(), "<name of template> <path to xml file> : Property automaton.")
+            ("neg,n", po::value<std::vector<std::string>>()->required()->multitoken(), "<name of template> <path to xml file> : Negated property automaton.")
+            ("output,o", po::value<std::string>()->required(), "<path> : Where to write the compiled model.")
+            ("div,d", "Only consider time divergent runs.")
+            ("silent,s", "removes all outputs");
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(options).run(), vm);
+
+    if (vm.count("help")) {
+        std::cout << options << std::endl;
+        return 1;
+    }
+
+    try {
+        po::notify(vm);
+    } catch (boost::wrapexcept<po::required_option>& e) {
+        std::cerr << "Error: Some required fields not given\n";
+        exit(-1);
+    }
+
+    auto posarg = vm["pos"].as<std::vector<std::string>>();
+    auto negarg = vm["neg"].as<std::vector<std::string>>();
+
+    if (posarg.size() != 2 || negarg.size() != 2) {
+        std::cerr << "Error: --pos and --neg args require two arguments\n";
+        exit(-1);
+    }
+
+    auto output = vm["output"].as<std::string>();
+
+    try {
+        ModelArtifact artifact(Parser::parse_file(&posarg[1][0], &posarg[0][0]),
+                               Parser::parse_file(&negarg[1][0], &negarg[0][0]), vm.count("div") > 0);
+        artifact.write(output);
+
+        if (not vm.count("silent"))
+            std::cout << "Compiled " << artifact.positive().name() << " (" << artifact.positive().locations().size()
+                      << " locations) and " << artifact.negative().name() << " ("
+                      << artifact.negative().locations().size() << " locations) into " << output << '\n';
+    } catch (const base_error& e) {
+        std::cerr << e.what() << '\n';
+        exit(-1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "monitaal/BinaryTrace.h"
+#include "errors.h"
+
+#include <boost/program_options.hpp>
+#include <iostream>
+
+namespace po = boost::program_options;
+using namespace monitaal;
+
+int main(int argc, const char** argv) {
+
+    po::options_description options;
+    options.add_options()
+            ("help,h", "Dispay this help message\nExample: monitaal-convert --input <path> --output <path>")
+            ("input,i", po::value<std::string>()->required(), "<path> : Text trace to convert.")
+            ("output,o", po::value<std::string>()->required(), "<path> : Where to write the binary trace.")
+            ("silent,s", "removes all outputs");
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(options).run(), vm);
+
+    if (vm.count("help")) {
+        std::cout << options << std::endl;
+        return 1;
+    }
+
+    try {
+        po::notify(vm);
+    } catch (boost::wrapexcept<po::required_option>& e) {
+        std::cerr << "Error: Some required fields not given\n";
+        exit(-1);
+    }
+
+    auto input = vm["input"].as<std::string>();
+    auto output = vm["output"].as<std::string>();
+
+    try {
+        auto events = BinaryTraceWriter::convert(input, output);
+
+        if (not vm.count("silent"))
+            std::cout << "Converted " << events << " events from " << input << " into " << output << '\n';
+    } catch (const base_error& e) {
+        std::cerr << e.what() << '\n';
+        exit(-1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "AsyncMonitor.h"
+
+#include <utility>
+
+namespace monitaal {
+
+    template<class state_t>
+    AsyncMonitor<state_t>::AsyncMonitor(std::vector<Monitor<state_t>> monitors, size_t queue_capacity) :
+            _monitors(std::move(monitors)), _promises(_monitors.size()), _queue(queue_capacity) {
+
+        _labels.intern(""); // Id 0, for unobserved labels
+        for (const auto& monitor : _monitors)
+            for (const auto* property : {monitor.positive_property().get(), monitor.negative_property().get()})
+                for (const auto& label : property->automaton().labels())
+                    _labels.intern(label);
+
+        for (size_t i = 0; i < _monitors.size(); ++i) {
+            _verdicts.push_back(_promises[i].get_future().share());
+
+            if (_monitors[i].status() != INCONCLUSIVE) {
+                _promises[i].set_value({_monitors[i].status(), 0, {0, 0}});
+                _subscriptions.emplace_back();
+                continue;
+            }
+
+            ++_undecided;
+            _subscriptions.push_back(_monitors[i].subscribe([this, i](const verdict_change_t& change) {
+                _promises[i].set_value(change);
+                --_undecided;
+            }));
+        }
+
+        _worker = std::thread([this]() { run(); });
+    }
+
+    template<class state_t>
+    AsyncMonitor<state_t>::AsyncMonitor(Monitor<state_t> monitor, size_t queue_capacity) :
+            AsyncMonitor(std::vector<Monitor<state_t>>{std::move(monitor)}, queue_capacity) {}
+
+    template<class state_t>
+    AsyncMonitor<state_t>::~AsyncMonitor() {
+        try {
+            close();
+        } catch (...) {}
+    }
+
+    template<class state_t>
+    void AsyncMonitor<state_t>::run() {
+        interned_event_t item;
+        interval_t last{0, 0};
+        try {
+            while (_undecided > 0 && _queue.pop(item)) {
+                const event_t event{item.time, item.label, _labels.label(item.label), item.type};
+                for (auto& monitor : _monitors)
+                    if (monitor.status() == INCONCLUSIVE)
+                        monitor.input(event);
+                last = item.time;
+            }
+        } catch (...) {
+            _error = std::current_exception();
+        }
+        _queue.close();
+
+        for (size_t i = 0; i < _monitors.size(); ++i) {
+            if (_monitors[i].status() != INCONCLUSIVE)
+                continue;
+            if (_error)
+                _promises[i].set_exception(_error);
+            else
+                _promises[i].set_value({INCONCLUSIVE, _monitors[i].events(), last});
+        }
+
+        // The callbacks refer to this, and the monitors may be copied after close()
+        for (size_t i = 0; i < _monitors.size(); ++i)
+            if (_subscriptions[i])
+                _monitors[i].unsubscribe(*_subscriptions[i]);
+    }
+
+    template<class state_t>
+    label_id_t AsyncMonitor<state_t>::label_id(std::string_view label) const {
+        return _labels.find(label).value_or(0);
+    }
+
+    template<class state_t>
+    bool AsyncMonitor<state_t>::push(const interned_event_t& event) {
+        return _queue.push(event);
+    }
+
+    template<class state_t>
+    bool AsyncMonitor<state_t>::try_push(const interned_event_t& event) {
+        return _queue.try_push(event);
+    }
+
+    template<class state_t>
+    std::shared_future<verdict_change_t> AsyncMonitor<state_t>::verdict(size_t monitor) const {
+        return _verdicts.at(monitor);
+    }
+
+    template<class state_t>
+    void AsyncMonitor<state_t>::close() {
+        if (_closed)
+            return;
+        _closed = true;
+
+        _queue.close();
+        if (_worker.joinable())
+            _worker.join();
+        if (_error)
+            std::rethrow_exception(_error);
+    }
+
+    template<class state_t>
+    const Monitor<state_t>& AsyncMonitor<state_t>::monitor(size_t monitor) const {
+        return _monitors.at(monitor);
+    }
+
+    template<class state_t>
+    size_t AsyncMonitor<state_t>::size() const { return _monitors.size(); }
+
+    template class AsyncMonitor<symbolic_state_t>;
+    template class AsyncMonitor<concrete_state_t>;
+    template class AsyncMonitor<delay_state_t>;
+    template class AsyncMonitor<testing_state_t>;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_ASYNC_MONITOR_H
+#define MONITAAL_ASYNC_MONITOR_H
+
+#include "Monitor.h"
+#include "LabelTable.h"
+#include "MPSCRing.h"
+
+#include <exception>
+#include <future>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace monitaal {
+
+    // An event whose label is interned by AsyncMonitor::label_id, such that producers neither copy nor hash labels
+    struct interned_event_t {
+        interval_t time{0, 0};
+        label_id_t label = 0;
+        input_type_e type = ONCE;
+    };
+
+    /**
+     * Monitors events from any number of threads without blocking them on the monitors. Events are queued in a
+     * lock-free ring and monitored in order of the queue by a worker thread that owns the monitors, so an event that
+     * should be ordered after another must be pushed after it returns.
+     *
+     * The labels of all monitors are interned when constructing, and producers push interned events. Every monitor
+     * gets an event until its verdict is decided, and the future of its verdict is then ready with the deciding event
+     * (see verdict_change_t). Once every verdict is decided, the queue is closed and push returns false.
+     */
+    template<class state_t>
+    class AsyncMonitor {
+        std::vector<Monitor<state_t>> _monitors;
+
+        // Not changed after construction, so producers may look up labels concurrently
+        LabelTable _labels;
+
+        std::vector<std::promise<verdict_change_t>> _promises;
+        std::vector<std::shared_future<verdict_change_t>> _verdicts;
+        std::vector<std::optional<uint64_t>> _subscriptions; // Of this, nothing for monitors decided when constructing
+        size_t _undecided = 0; // Owned by the worker
+
+        MPSCRing<interned_event_t> _queue;
+        std::thread _worker;
+        std::exception_ptr _error; // Thrown by the worker, rethrown by close()
+        bool _closed = false;
+
+        void run();
+
+    public:
+        explicit AsyncMonitor(std::vector<Monitor<state_t>> monitors, size_t queue_capacity = 4096);
+
+        explicit AsyncMonitor(Monitor<state_t> monitor, size_t queue_capacity = 4096);
+
+        AsyncMonitor(const AsyncMonitor&) = delete;
+        AsyncMonitor& operator=(const AsyncMonitor&) = delete;
+
+        // Closes the queue without reporting errors of the worker
+        ~AsyncMonitor();
+
+        /**
+         * The id of a label for interned_event_t. Labels that no monitor observes only let time pass, and all get
+         * the id of the empty label. Any thread.
+         */
+        [[nodiscard]] label_id_t label_id(std::string_view label) const;
+
+        /**
+         * Any thread. Waits while the queue is full. Returns false if the queue is closed, i.e. by close() or
+         * since every verdict is decided.
+         */
+        bool push(const interned_event_t& event);
+
+        // Any thread. Returns false if the queue is full or closed
+        bool try_push(const interned_event_t& event);
+
+        /**
+         * Any thread. Ready once the verdict of the monitor is decided, or with an inconclusive verdict and the number
+         * of monitored events once the queue is closed and drained. Holds the error if the worker failed.
+         */
+        [[nodiscard]] std::shared_future<verdict_change_t> verdict(size_t monitor = 0) const;
+
+        /**
+         * Closes the queue, waits for the worker to monitor the queued events and rethrows its error, if any.
+         * Called by the owner, after the producers are done.
+         */
+        void close();
+
+        // After close()
+        [[nodiscard]] const Monitor<state_t>& monitor(size_t monitor = 0) const;
+
+        [[nodiscard]] size_t size() const;
+    };
+}
+
+#endif //MONITAAL_ASYNC_MONITOR_H
@@ -0,0 +1,174 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_BINARY_IO_H
+#define MONITAAL_BINARY_IO_H
+
+#include "types.h"
+#include "errors.h"
+
+#include <pardibaal/DBM.h>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+/** BINARY IO
+ *  Fixed width little endian encoding shared by model artifacts and monitor checkpoints.
+ *
+ *      Bound := VALUE:i32 KIND:u8   (0 = non strict, 1 = strict, 2 = infinity)
+ *      Zone := Bound^(DIMENSION^2)  (row major)
+ *      String := u32 BYTES
+ */
+
+namespace monitaal {
+
+    struct binary_writer_t {
+        enum bound_kind_e : uint8_t {NON_STRICT = 0, STRICT = 1, INFINITY_BOUND = 2};
+
+        std::ostream& out;
+
+        template<class T>
+        void raw(T value) {
+            static_assert(std::is_integral_v<T>);
+            char bytes[sizeof(T)];
+            for (size_t i = 0; i < sizeof(T); ++i)
+                bytes[i] = static_cast<char>((static_cast<std::make_unsigned_t<T>>(value) >> (8 * i)) & 0xff);
+            out.write(bytes, sizeof(T));
+        }
+
+        void u32(size_t value) { raw<uint32_t>(static_cast<uint32_t>(value)); }
+
+        void string(const std::string& s) {
+            u32(s.size());
+            out.write(s.data(), static_cast<std::streamsize>(s.size()));
+        }
+
+        void bound(const pardibaal::bound_t& b) {
+            raw<int32_t>(b.is_inf() ? 0 : b.get_bound());
+            raw<uint8_t>(b.is_inf() ? INFINITY_BOUND : (b.is_strict() ? STRICT : NON_STRICT));
+        }
+
+        void constraints(const constraints_t& cs) {
+            u32(cs.size());
+            for (const auto& c : cs) {
+                u32(c._i);
+                u32(c._j);
+                bound(c._bound);
+            }
+        }
+
+        template<class zone_t>
+        void zone(const zone_t& z) {
+            for (clock_index_t i = 0; i < z.dimension(); ++i)
+                for (clock_index_t j = 0; j < z.dimension(); ++j)
+                    bound(z.at(i, j));
+        }
+    };
+
+    struct binary_reader_t {
+        const char* data;
+        size_t size;
+        size_t offset = 0;
+
+        // What is read, e.g. "Model artifact", for error messages
+        const char* what = "Binary file";
+
+        void need(size_t bytes) const {
+            if (size - offset < bytes)
+                throw base_error("Error: ", what, " is truncated at byte ", offset);
+        }
+
+        // Checks a count read from the file before anything is allocated for count items of at least width bytes
+        void need(uint64_t count, size_t width) const {
+            if (count > (size - offset) / width)
+                throw base_error("Error: ", what, " is truncated at byte ", offset);
+        }
+
+        template<class T>
+        T raw() {
+            static_assert(std::is_integral_v<T>);
+            need(sizeof(T));
+            std::make_unsigned_t<T> value = 0;
+            for (size_t i = 0; i < sizeof(T); ++i)
+                value |= static_cast<std::make_unsigned_t<T>>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+            offset += sizeof(T);
+            return static_cast<T>(value);
+        }
+
+        uint32_t u32() { return raw<uint32_t>(); }
+
+        // A clock index in a DBM of number_of_clocks + 1 clocks
+        clock_index_t clock(clock_index_t number_of_clocks) {
+            auto index = u32();
+            if (index > number_of_clocks)
+                throw base_error("Error: ", what, " has clock index ", index, " of ", number_of_clocks,
+                                 " clocks at byte ", offset - 4);
+            return index;
+        }
+
+        std::string string() {
+            auto length = u32();
+            need(length);
+            std::string rtn(data + offset, length);
+            offset += length;
+            return rtn;
+        }
+
+        pardibaal::bound_t bound() {
+            auto value = raw<int32_t>();
+            switch (raw<uint8_t>()) {
+                case binary_writer_t::NON_STRICT: return pardibaal::bound_t::non_strict(value);
+                case binary_writer_t::STRICT: return pardibaal::bound_t::strict(value);
+                case binary_writer_t::INFINITY_BOUND: return pardibaal::bound_t::inf();
+                default: throw base_error("Error: ", what, " has an invalid bound at byte ", offset - 1);
+            }
+        }
+
+        constraints_t constraints(clock_index_t number_of_clocks) {
+            constraints_t rtn;
+            auto n = u32();
+            need(n, 13);
+            for (uint32_t k = 0; k < n; ++k) {
+                auto i = clock(number_of_clocks), j = clock(number_of_clocks);
+                rtn.push_back(constraint_t(i, j, bound()));
+            }
+            return rtn;
+        }
+
+        // A zone as the constraints that are not trivial, i.e. the bounds that are not on the diagonal or infinite
+        constraints_t zone(clock_index_t dimension) {
+            constraints_t rtn;
+            for (clock_index_t i = 0; i < dimension; ++i)
+                for (clock_index_t j = 0; j < dimension; ++j) {
+                    auto b = bound();
+                    if (i != j && not b.is_inf())
+                        rtn.push_back(constraint_t(i, j, b));
+                }
+            return rtn;
+        }
+    };
+}
+
+#endif //MONITAAL_BINARY_IO_H
@@ -0,0 +1,246 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "BinaryTrace.h"
+#include "EventParser.h"
+#include "errors.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace monitaal {
+
+    namespace {
+        constexpr char magic[4] = {'M', 'T', 'T', 'R'};
+
+        void write_u32(std::ostream& out, uint32_t value) {
+            char bytes[4];
+            for (size_t i = 0; i < 4; ++i)
+                bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+            out.write(bytes, 4);
+        }
+
+        // Appends value as a varint to buffer and returns the position after it
+        char* put_varint(char* buffer, uint64_t value) {
+            while (value >= 0x80) {
+                *buffer++ = static_cast<char>((value & 0x7f) | 0x80);
+                value >>= 7;
+            }
+            *buffer++ = static_cast<char>(value);
+            return buffer;
+        }
+
+        uint64_t zigzag(int64_t value) { return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); }
+
+        int64_t unzigzag(uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+        struct reader_t {
+            const char* data;
+            size_t size;
+            size_t offset;
+
+            uint32_t u32() {
+                if (size - offset < 4)
+                    throw base_error("Error: Binary trace is truncated at byte ", offset);
+                uint32_t value = 0;
+                for (size_t i = 0; i < 4; ++i)
+                    value |= static_cast<uint32_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+                offset += 4;
+                return value;
+            }
+
+            uint64_t varint() {
+                auto begin = offset;
+                uint64_t value = 0;
+                for (uint32_t shift = 0; shift < 64; shift += 7) {
+                    if (offset == size)
+                        throw base_error("Error: Binary trace is truncated at byte ", offset);
+                    auto byte = static_cast<uint8_t>(data[offset++]);
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0)
+                        return value;
+                }
+                throw base_error("Error: Binary trace has a malformed number at byte ", begin);
+            }
+        };
+    }
+
+    BinaryTraceWriter::BinaryTraceWriter(std::ostream& out, const LabelTable& labels) :
+            _out(out), _number_of_labels(labels.size()) {
+        _out.write(magic, sizeof(magic));
+        write_u32(_out, version);
+        write_u32(_out, static_cast<uint32_t>(labels.size()));
+        for (label_id_t id = 0; id < labels.size(); ++id) {
+            const auto& label = labels.label(id);
+            write_u32(_out, static_cast<uint32_t>(label.size()));
+            _out.write(label.data(), static_cast<std::streamsize>(label.size()));
+        }
+    }
+
+    void BinaryTraceWriter::write(const event_t& event) {
+        if (event.id >= _number_of_labels)
+            throw base_error("Error: Label id ", event.id, " is not in the binary trace header");
+        if (event.time.second < event.time.first)
+            throw base_error("Error: Interval [", event.time.first, ", ", event.time.second, "] is empty");
+        if (not event.session.empty())
+            throw base_error("Error: Binary traces have no session keys, but an event has session ", event.session);
+
+        bool interval = event.time.first != event.time.second;
+
+        char buffer[32];
+        char* end = put_varint(buffer, static_cast<uint64_t>(event.id) << 3 | static_cast<uint64_t>(event.type) << 1 | interval);
+        end = put_varint(end, zigzag(static_cast<int64_t>(event.time.first) - static_cast<int64_t>(_previous)));
+        if (interval)
+            end = put_varint(end, event.time.second - event.time.first);
+        _out.write(buffer, end - buffer);
+
+        _previous = event.time.first;
+    }
+
+    size_t BinaryTraceWriter::convert(const std::string& text_path, const std::string& binary_path) {
+        MappedEventParser parser(text_path);
+
+        // The header holds all labels, so the first pass only interns them. The ids are the same in the second pass
+        size_t events = 0;
+        for (auto it = parser.begin(); it != parser.end(); ++it)
+            ++events;
+
+        std::ofstream out(binary_path, std::ios::binary | std::ios::trunc);
+        if (not out)
+            throw base_error("Error: Could not open ", binary_path, " for writing");
+
+        BinaryTraceWriter writer(out, parser.labels());
+        for (const auto& event : parser)
+            writer.write(event);
+
+        if (not out.flush())
+            throw base_error("Error: Could not write binary trace to ", binary_path);
+
+        return events;
+    }
+
+    BinaryTraceReader::BinaryTraceReader(const std::string& path) :
+            _file(path, "binary trace", true), _data(_file.data()), _size(_file.size()) {
+        read_header();
+    }
+
+    BinaryTraceReader::BinaryTraceReader(const char* data, size_t size) : _data(data), _size(size) {
+        read_header();
+    }
+
+    void BinaryTraceReader::read_header() {
+        if (_size < sizeof(magic) || std::memcmp(_data, magic, sizeof(magic)) != 0)
+            throw base_error("Error: Not a MoniTAal binary trace");
+
+        reader_t in{_data, _size, sizeof(magic)};
+
+        auto trace_version = in.u32();
+        if (trace_version != BinaryTraceWriter::version)
+            throw base_error("Error: Binary trace has version ", trace_version, " but version ",
+                             BinaryTraceWriter::version, " is expected. Convert the trace again");
+
+        auto number_of_labels = in.u32();
+        for (uint32_t i = 0; i < number_of_labels; ++i) {
+            auto length = in.u32();
+            if (_size - in.offset < length)
+                throw base_error("Error: Binary trace is truncated at byte ", in.offset);
+            if (_labels.intern(std::string_view(_data + in.offset, length)) != i)
+                throw base_error("Error: Binary trace has a duplicate label at byte ", in.offset);
+            in.offset += length;
+        }
+
+        _number_of_labels = number_of_labels;
+        _events = in.offset;
+    }
+
+    size_t BinaryTraceReader::parse(size_t offset, event_t& event) const {
+        if (offset == _size)
+            return npos;
+
+        reader_t in{_data, _size, offset};
+
+        auto tag = in.varint();
+        auto id = tag >> 3;
+        auto type = (tag >> 1) & 3;
+        if (id >= _number_of_labels)
+            throw base_error("Error: Binary trace has an unknown label id ", id, " at byte ", offset);
+        if (type > MULTI)
+            throw base_error("Error: Binary trace has an unknown input type at byte ", offset);
+
+        auto lower = static_cast<int64_t>(event.time.first) + unzigzag(in.varint());
+        uint64_t width = (tag & 1) ? in.varint() : 0;
+        if (lower < 0 || static_cast<uint64_t>(lower) + width > std::numeric_limits<symb_time_t>::max())
+            throw base_error("Error: Binary trace has a time point out of range at byte ", offset);
+
+        event.time = {static_cast<symb_time_t>(lower), static_cast<symb_time_t>(lower + width)};
+        if (not _observed.empty() && not _observed[id]) {
+            event.id = _unobserved;
+            event.label = std::string_view();
+        } else {
+            event.id = static_cast<label_id_t>(id);
+            event.label = _labels.label(event.id);
+        }
+        event.type = static_cast<input_type_e>(type);
+
+        return in.offset;
+    }
+
+    void BinaryTraceReader::set_alphabet(const PerfectHash& alphabet) {
+        _unobserved = _labels.intern("");
+
+        _observed.assign(_number_of_labels, false);
+        for (label_id_t id = 0; id < _number_of_labels; ++id)
+            _observed[id] = alphabet.contains(_labels.label(id));
+    }
+
+    bool BinaryTraceReader::is_binary_trace(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        char start[sizeof(magic)];
+        return file.read(start, sizeof(magic)) && std::memcmp(start, magic, sizeof(magic)) == 0;
+    }
+
+    BinaryTraceReader::iterator::iterator(const BinaryTraceReader* reader, size_t offset) : _reader(reader) {
+        _next = _reader->parse(offset, _event);
+    }
+
+    BinaryTraceReader::iterator& BinaryTraceReader::iterator::operator++() {
+        _next = _reader->parse(_next, _event);
+        return *this;
+    }
+
+    BinaryTraceReader::iterator BinaryTraceReader::iterator::operator++(int) {
+        auto rtn = *this;
+        ++*this;
+        return rtn;
+    }
+
+    BinaryTraceReader::iterator BinaryTraceReader::begin() const { return {this, _events}; }
+
+    BinaryTraceReader::iterator BinaryTraceReader::end() const {
+        iterator rtn;
+        rtn._reader = this;
+        return rtn;
+    }
+
+    const LabelTable& BinaryTraceReader::labels() const { return _labels; }
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MONITAAL_BINARY_TRACE_H
+#define MONITAAL_BINARY_TRACE_H
+
+#include "Monitor.h"
+#include "LabelTable.h"
+#include "MappedFile.h"
+#include "PerfectHash.h"
+#include "types.h"
+
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** BINARY TRACE
+ *  A compact binary form of a timed word. The labels are stored once in the header and events refer to them by id.
+ *  Times are delta encoded, so a typical event takes 2-3 bytes.
+ *
+ *  Binary layout (little endian):
+ *
+ *      Trace := "MTTR" VERSION:u32 u32 String* (labels, the index is the label id) Event*
+ *
+ *      Event := TAG:varint DELTA:varint [WIDTH:varint]
+ *
+ *      TAG   = label id << 3 | input_type_e << 1 | 1 if the time is an interval [l, u] with l != u
+ *      DELTA = zigzag encoded l minus l of the previous event (0 for the first event)
+ *      WIDTH = u - l, only present for intervals
+ *
+ *      String := u32 BYTES
+ *      varint := unsigned LEB128, i.e. 7 bits per byte with the high bit set on all but the last byte
+ */
+
+namespace monitaal {
+
+    class BinaryTraceWriter {
+        std::ostream& _out;
+
+        size_t _number_of_labels;
+
+        symb_time_t _previous = 0;
+
+    public:
+        static constexpr uint32_t version = 1;
+
+        /**
+         * Writes the header. All events must have an id of one of the given labels and no session key.
+         */
+        BinaryTraceWriter(std::ostream& out, const LabelTable& labels);
+
+        void write(const event_t& event);
+
+        /**
+         * Converts a text trace (see EventParser) to a binary trace. Returns the number of events.
+         * Throws base_error if the text trace cannot be parsed or the binary trace cannot be written. Session keys are
+         * not read, as in monitaal-bin without --sessions, so a trace with a session key before a label is not parsed.
+         */
+        static size_t convert(const std::string& text_path, const std::string& binary_path);
+    };
+
+    /**
+     * Reads a binary trace, e.g. from a memory mapped file. Events are produced lazily by a forward iterator, in the
+     * same way as the MappedEventParser. The label of an event is a view of the label interned in labels().
+     * Errors are reported as base_error with the byte offset.
+     */
+    class BinaryTraceReader {
+        MappedFile _file;
+
+        const char* _data;
+        size_t _size;
+
+        LabelTable _labels;
+        size_t _number_of_labels = 0; // In the header
+
+        size_t _events; // Offset of the first event
+
+        std::vector<bool> _observed; // By label id, empty if there is no alphabet
+        label_id_t _unobserved = 0;
+
+        void read_header();
+
+        // Parses the event at offset, relative to the time of the previous event in event. Returns the offset after the
+        // event, or npos if there are no more events.
+        size_t parse(size_t offset, event_t& event) const;
+
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        class iterator {
+            friend class BinaryTraceReader;
+
+            const BinaryTraceReader* _reader = nullptr;
+            size_t _next = npos;
+            event_t _event;
+
+            iterator(const BinaryTraceReader* reader, size_t offset);
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _event; }
+            pointer operator->() const { return &_event; }
+
+            iterator& operator++();
+            iterator operator++(int);
+
+            bool operator==(const iterator& other) const { return _next == other._next; }
+        };
+
+        /**
+         * Maps the file read-only. Throws base_error if it cannot be mapped or is not a binary trace of this version.
+         */
+        explicit BinaryTraceReader(const std::string& path);
+
+        /**
+         * Reads a buffer owned by the caller. The buffer must outlive the reader.
+         */
+        BinaryTraceReader(const char* data, size_t size);
+
+        BinaryTraceReader(const BinaryTraceReader&) = delete;
+        BinaryTraceReader& operator=(const BinaryTraceReader&) = delete;
+
+        /**
+         * Labels outside the alphabet are replaced by the empty label (only the time of the event is kept).
+         * The alphabet is resolved against the header once, so events are filtered by their id.
+         */
+        void set_alphabet(const PerfectHash& alphabet);
+
+        /**
+         * True if the file starts like a binary trace, i.e. it should be read with a BinaryTraceReader.
+         */
+        static bool is_binary_trace(const std::string& path);
+
+        iterator begin() const;
+        iterator end() const;
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+}
+
+#endif //MONITAAL_BINARY_TRACE_H
@@ -0,0 +1,80 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "CompiledProperty.h"
+#include "Fixpoint.h"
+
+#include <utility>
+
+namespace monitaal {
+
+    namespace {
+        bool lower_bound_invariant(const TA& T) {
+            for (const auto& [_, location] : T.locations())
+                for (const auto& c : location.invariant())
+                    if (c._i == 0 && c._j != 0 &&
+                        (c._bound.get_bound() < 0 || (c._bound.get_bound() == 0 && c._bound.is_strict())))
+                        return true;
+            return false;
+        }
+    }
+
+    template<class space_state_t>
+    CompiledProperty<space_state_t>::CompiledProperty(TA automaton, bool time_divergence) :
+            _automaton(std::move(automaton)),
+            _accepting_space(Fixpoint<space_state_t>::buchi_accept_fixpoint(_automaton, time_divergence)),
+            _time_divergence(time_divergence),
+            _lower_bound_invariant(lower_bound_invariant(_automaton)) {}
+
+    template<class space_state_t>
+    CompiledProperty<space_state_t>::CompiledProperty(TA automaton, symbolic_state_map_t<space_state_t> accepting_space,
+                                                      bool time_divergence) :
+            _automaton(std::move(automaton)),
+            _accepting_space(std::move(accepting_space)),
+            _time_divergence(time_divergence),
+            _lower_bound_invariant(lower_bound_invariant(_automaton)) {}
+
+    template<class space_state_t>
+    std::shared_ptr<const CompiledProperty<space_state_t>>
+    CompiledProperty<space_state_t>::compile(TA automaton, bool time_divergence) {
+        return std::make_shared<const CompiledProperty>(std::move(automaton), time_divergence);
+    }
+
+    template<class space_state_t>
+    const TA& CompiledProperty<space_state_t>::automaton() const { return _automaton; }
+
+    template<class space_state_t>
+    const symbolic_state_map_t<space_state_t>& CompiledProperty<space_state_t>::accepting_space() const {
+        return _accepting_space;
+    }
+
+    template<class space_state_t>
+    bool CompiledProperty<space_state_t>::time_divergence() const { return _time_divergence; }
+
+    template<class space_state_t>
+    bool CompiledProperty<space_state_t>::has_lower_bound_invariant() const { return _lower_bound_invariant; }
+
+    template class CompiledProperty<symbolic_state_t>;
+    template class CompiledProperty<delay_state_t>;
+    template class CompiledProperty<testing_state_t>;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_COMPILED_PROPERTY_H
+#define MONITAAL_COMPILED_PROPERTY_H
+
+#include "TA.h"
+#include "state.h"
+#include "types.h"
+
+#include <memory>
+
+namespace monitaal {
+
+    /**
+     * One automaton of a property together with everything a monitor derives from it: the accepting space over
+     * space_state_t and whether the invariants have lower bounds. It is immutable once built, so any number of
+     * monitors share it through a property_ptr_t and a monitor only owns its state estimate.
+     */
+    template<class space_state_t>
+    class CompiledProperty {
+        const TA _automaton;
+
+        // Where it is still possible to reach an accepting location infinitely often
+        const symbolic_state_map_t<space_state_t> _accepting_space;
+
+        const bool _time_divergence;
+
+        const bool _lower_bound_invariant;
+
+    public:
+        // Computes the accepting space
+        CompiledProperty(TA automaton, bool time_divergence);
+
+        // With an accepting space that is already computed, e.g. loaded from a model artifact
+        CompiledProperty(TA automaton, symbolic_state_map_t<space_state_t> accepting_space, bool time_divergence);
+
+        CompiledProperty(const CompiledProperty&) = delete;
+        CompiledProperty& operator=(const CompiledProperty&) = delete;
+
+        static std::shared_ptr<const CompiledProperty> compile(TA automaton, bool time_divergence);
+
+        [[nodiscard]] const TA& automaton() const;
+
+        [[nodiscard]] const symbolic_state_map_t<space_state_t>& accepting_space() const;
+
+        // Only time divergent runs are considered by the accepting space
+        [[nodiscard]] bool time_divergence() const;
+
+        // True if an invariant has a lower bound on a clock, which is violated before a delay but not after it
+        [[nodiscard]] bool has_lower_bound_invariant() const;
+    };
+
+    template<class space_state_t>
+    using property_ptr_t = std::shared_ptr<const CompiledProperty<space_state_t>>;
+}
+
+#endif //MONITAAL_COMPILED_PROPERTY_H
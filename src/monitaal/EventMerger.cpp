@@ -0,0 +1,140 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "EventMerger.h"
+#include "errors.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace monitaal {
+
+    namespace {
+        // The heap is a max-heap, so the entry that comes last is the greatest
+        struct later_t {
+            template<class entry_t>
+            bool operator()(const entry_t& a, const entry_t& b) const {
+                if (a.event.time.first != b.event.time.first)
+                    return a.event.time.first > b.event.time.first;
+                if (a.event.time.second != b.event.time.second)
+                    return a.event.time.second > b.event.time.second;
+                return a.rank > b.rank;
+            }
+        };
+    }
+
+    size_t EventMerger::add_source(std::string name, std::shared_ptr<void> owner, std::function<bool(event_t&)> next) {
+        if (_started)
+            throw base_error("Error: Sources cannot be added to an EventMerger that is being read");
+        if (name.empty())
+            name = "source " + std::to_string(_sources.size());
+
+        auto rank = static_cast<uint32_t>(_sources.size());
+        _sources.push_back({std::move(name), std::move(owner), std::move(next), {}, rank});
+        return _sources.size() - 1;
+    }
+
+    void EventMerger::set_tie_break(const std::vector<size_t>& order) {
+        std::vector<bool> ranked(_sources.size(), false);
+        uint32_t rank = 0;
+        for (auto source : order) {
+            if (source >= _sources.size() || ranked[source])
+                throw base_error("Error: The tie-break order must list each source at most once, but got ", source);
+            ranked[source] = true;
+            _sources[source].rank = rank++;
+        }
+        for (size_t source = 0; source < _sources.size(); ++source)
+            if (not ranked[source])
+                _sources[source].rank = rank++;
+    }
+
+    void EventMerger::pull(size_t index) {
+        auto& source = _sources[index];
+        entry_t entry{{}, source.rank, index};
+        if (not source.next(entry.event))
+            return;
+        ++source.events;
+
+        // The previous event of the source has just been taken, so it is the current event
+        if (source.events > 1 && entry.event.time.first < _event.time.first)
+            throw base_error("Error: Event ", source.events, " of ", source.name, " is at ", entry.event.time.first,
+                             " which is before the previous event at ", _event.time.first);
+
+        constexpr auto unmapped = std::numeric_limits<label_id_t>::max();
+        if (entry.event.id >= source.ids.size())
+            source.ids.resize(entry.event.id + 1, unmapped);
+        auto& id = source.ids[entry.event.id];
+        if (id == unmapped)
+            id = _labels.intern(entry.event.label);
+        entry.event.id = id;
+
+        // The source may reuse the memory of labels and sessions once it advances, which is before the event is taken
+        entry.event.label = _labels.label(id);
+        if (not entry.event.session.empty())
+            entry.event.session = _sessions.label(_sessions.intern(entry.event.session));
+
+        _heap.push_back(entry);
+        std::push_heap(_heap.begin(), _heap.end(), later_t());
+    }
+
+    bool EventMerger::next() {
+        if (_heap.empty())
+            return false;
+
+        std::pop_heap(_heap.begin(), _heap.end(), later_t());
+        _event = _heap.back().event;
+        auto source = _heap.back().source;
+        _heap.pop_back();
+
+        pull(source);
+        return true;
+    }
+
+    EventMerger::iterator::iterator(EventMerger* merger) : _merger(merger) {
+        if (not _merger->next())
+            _merger = nullptr;
+    }
+
+    EventMerger::iterator& EventMerger::iterator::operator++() {
+        if (not _merger->next())
+            _merger = nullptr;
+        return *this;
+    }
+
+    EventMerger::iterator EventMerger::begin() {
+        if (_started)
+            throw base_error("Error: An EventMerger can only be read once");
+        _started = true;
+
+        _heap.reserve(_sources.size());
+        for (size_t source = 0; source < _sources.size(); ++source)
+            pull(source);
+        return iterator(this);
+    }
+
+    EventMerger::iterator EventMerger::end() { return {}; }
+
+    size_t EventMerger::number_of_sources() const { return _sources.size(); }
+
+    const LabelTable& EventMerger::labels() const { return _labels; }
+}
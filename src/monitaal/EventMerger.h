@@ -0,0 +1,164 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_EVENT_MERGER_H
+#define MONITAAL_EVENT_MERGER_H
+
+#include "Monitor.h"
+#include "LabelTable.h"
+#include "types.h"
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace monitaal {
+
+    /**
+     * Reads a range of events one event at a time: each call stores the next event in event, or returns false if
+     * there are no more. The range is only started on the first call.
+     */
+    template<class range_t>
+    std::function<bool(event_t&)> event_reader(range_t& events) {
+        return [&events, it = decltype(events.begin()){}, started = false](event_t& event) mutable {
+            if (not started) {
+                it = events.begin();
+                started = true;
+            } else
+                ++it;
+            if (it == events.end())
+                return false;
+            event = *it;
+            return true;
+        };
+    }
+
+    /**
+     * Merges several event sources, each ordered by time, into one timed word ordered by time, e.g. the logs of the
+     * components of a system. Each source is read one event at a time, and the next event is taken from a heap of the
+     * first unread event of each source, so merging k sources costs O(log k) per event in O(k) memory.
+     *
+     * Events are ordered by the lower bound of their time, then by the upper bound. Events at equal times are taken
+     * from the sources in tie-break order, which is the order in which they are added unless set_tie_break is called.
+     * Ids of the merged events are interned in labels(), and labels and sessions are owned by the merger, so they
+     * stay valid while the merger is alive.
+     * Throws base_error if a source is not ordered by time.
+     */
+    class EventMerger {
+        struct source_t {
+            std::string name;
+            std::shared_ptr<void> owner;             // Keeps an owned source alive
+            std::function<bool(event_t&)> next;      // Reads the next event of the source
+            std::vector<label_id_t> ids;             // Merged id by id in the source
+            uint32_t rank;                           // Position in the tie-break order
+            size_t events = 0;                       // Number of events read
+        };
+
+        struct entry_t {
+            event_t event;
+            uint32_t rank;
+            size_t source;
+        };
+
+        std::vector<source_t> _sources;
+        std::vector<entry_t> _heap;
+        bool _started = false;
+
+        LabelTable _labels, _sessions;
+
+        event_t _event;
+
+        // Reads the next event of a source into the heap
+        void pull(size_t source);
+
+        size_t add_source(std::string name, std::shared_ptr<void> owner, std::function<bool(event_t&)> next);
+
+        // Moves the next event into _event. Returns false if there are no more events
+        bool next();
+
+    public:
+        class iterator {
+            friend class EventMerger;
+
+            EventMerger* _merger = nullptr; // nullptr when there are no more events
+
+            explicit iterator(EventMerger* merger);
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _merger->_event; }
+            pointer operator->() const { return &_merger->_event; }
+
+            iterator& operator++();
+            void operator++(int) { ++*this; }
+
+            bool operator==(const iterator& other) const { return _merger == other._merger; }
+        };
+
+        EventMerger() = default;
+
+        EventMerger(const EventMerger&) = delete;
+        EventMerger& operator=(const EventMerger&) = delete;
+
+        /**
+         * Adds a range of events, e.g. a MappedEventParser, which must outlive the merger. Returns the index of the
+         * source. The name is used in errors.
+         */
+        template<class range_t>
+        size_t add(range_t& events, std::string name = "") {
+            return add_source(std::move(name), nullptr, event_reader(events));
+        }
+
+        // Adds a range of events that is owned by the merger
+        template<class range_t>
+        size_t add(std::shared_ptr<range_t> events, std::string name = "") {
+            auto next = event_reader(*events);
+            return add_source(std::move(name), std::move(events), std::move(next));
+        }
+
+        /**
+         * Events at equal times are taken from the sources in the given order of their indices. Sources that are not
+         * in the order come after, in the order they are added. Must be called before begin().
+         */
+        void set_tie_break(const std::vector<size_t>& order);
+
+        // Starts reading the sources. Can only be called once
+        iterator begin();
+        iterator end();
+
+        [[nodiscard]] size_t number_of_sources() const;
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+}
+
+#endif //MONITAAL_EVENT_MERGER_H
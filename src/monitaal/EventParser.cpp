@@ -29,6 +29,10 @@
 #include <istream>
 #include <iostream>
 #include <locale>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 
 namespace monitaal {
 
@@ -109,4 +113,326 @@ namespace monitaal {
         return events;
     }
 
-}
\ No newline at end of file
+    StreamEventParser::StreamEventParser(std::istream& stream) : _stream(stream) {}
+
+    bool StreamEventParser::next() {
+        _stream >> std::ws;
+        if (_stream.eof() || _stream.peek() == '\000')
+            return false;
+
+        read_seperator(&_stream);
+        _event.time = read_time(&_stream);
+
+        auto read_label = [this](std::string& label) {
+            label.clear();
+            skip_space(&_stream);
+            for (char c = _stream.peek(); c != '\n' && c != '@' && !_stream.eof() && c != '\000' && c != '\t' && c != ' ';
+                 c = _stream.peek())
+                label += static_cast<char>(_stream.get());
+        };
+
+        read_label(_label);
+        if (_sessions && not _label.empty() && _label[0] == '#') {
+            _session.assign(_label, 1);
+            _event.session = _session;
+            read_label(_label);
+        } else
+            _event.session = std::string_view();
+
+        if (_alphabet && not _alphabet->contains(_label)) {
+            _event.id = _unobserved;
+            _event.label = std::string_view();
+        } else {
+            _event.id = _labels.intern(_label);
+            _event.label = _labels.label(_event.id);
+        }
+        _event.type = ONCE;
+        return true;
+    }
+
+    void StreamEventParser::set_alphabet(PerfectHash alphabet) {
+        _alphabet = std::move(alphabet);
+        _unobserved = _labels.intern("");
+    }
+
+    void StreamEventParser::set_sessions(bool sessions) { _sessions = sessions; }
+
+    StreamEventParser::iterator::iterator(StreamEventParser* parser) : _parser(parser) {
+        if (not _parser->next())
+            _parser = nullptr;
+    }
+
+    StreamEventParser::iterator& StreamEventParser::iterator::operator++() {
+        if (not _parser->next())
+            _parser = nullptr;
+        return *this;
+    }
+
+    StreamEventParser::iterator StreamEventParser::begin() { return iterator(this); }
+
+    StreamEventParser::iterator StreamEventParser::end() { return {}; }
+
+    const LabelTable& StreamEventParser::labels() const { return _labels; }
+
+    MappedEventParser::MappedEventParser(const std::string& path) :
+            _file(path, "trace", true), _data(_file.data()), _size(_file.size()) {}
+
+    MappedEventParser::MappedEventParser(const char* data, size_t size) : _data(data), _size(size) {}
+
+    void MappedEventParser::set_alphabet(PerfectHash alphabet) {
+        _alphabet = std::move(alphabet);
+        _unobserved = _labels.intern("");
+    }
+
+    void MappedEventParser::set_sessions(bool sessions) { _sessions = sessions; }
+
+    namespace {
+        inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+        inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+        struct scanner_t {
+            const char* data;
+            size_t size;
+            size_t offset;
+
+            [[nodiscard]] bool done() const { return offset >= size || data[offset] == '\000'; }
+
+            [[nodiscard]] char peek() const { return done() ? '\000' : data[offset]; }
+
+            void skip_whitespace() { while (offset < size && is_space(data[offset])) ++offset; }
+
+            void skip_space() { while (offset < size && (data[offset] == ' ' || data[offset] == '\t')) ++offset; }
+
+            void expect(char c, const char* what) {
+                if (peek() != c)
+                    throw base_error("Error: Expected ", what, " at byte ", offset, " but got \"", peek(), "\"");
+                ++offset;
+            }
+
+            symb_time_t integer() {
+                if (not is_digit(peek()))
+                    throw base_error("Error: Expected a time point at byte ", offset, " but got \"", peek(), "\"");
+
+                uint64_t value = 0;
+                auto begin = offset;
+                while (is_digit(peek())) {
+                    value = value * 10 + (data[offset] - '0');
+                    if (value > std::numeric_limits<symb_time_t>::max())
+                        throw base_error("Error: Time point at byte ", begin, " is out of range");
+                    ++offset;
+                }
+                return static_cast<symb_time_t>(value);
+            }
+        };
+    }
+
+    size_t MappedEventParser::parse(size_t offset, event_t& event) {
+        scanner_t in{_data, _size, offset};
+
+        in.skip_whitespace();
+        if (in.done())
+            return npos;
+
+        in.expect('@', "a @ separator");
+        in.skip_whitespace();
+
+        if (in.peek() == '[') {
+            ++in.offset;
+            in.skip_whitespace();
+            auto lower = in.integer();
+            in.skip_whitespace();
+            in.expect(',', "\",\" in interval [l, u]");
+            in.skip_whitespace();
+            auto upper = in.integer();
+            in.skip_whitespace();
+            in.expect(']', "\"]\" in interval [l, u]");
+            event.time = {lower, upper};
+        } else {
+            auto time = in.integer();
+            event.time = {time, time};
+        }
+
+        // As in read_observation, a label ends at whitespace, '@' or the end of input. A newline gives an empty label
+        auto read_label = [&in]() {
+            in.skip_space();
+            auto begin = in.offset;
+            while (not in.done() && not is_space(in.data[in.offset]) && in.data[in.offset] != '@')
+                ++in.offset;
+            return begin;
+        };
+
+        auto begin = read_label();
+        if (_sessions && in.offset > begin && _data[begin] == '#') {
+            event.session = std::string_view(_data + begin + 1, in.offset - begin - 1);
+            begin = read_label();
+        } else
+            event.session = std::string_view();
+
+        event.label = std::string_view(_data + begin, in.offset - begin);
+        if (_alphabet && not _alphabet->contains(event.label)) {
+            event.label = std::string_view();
+            event.id = _unobserved;
+        } else
+            event.id = _labels.intern(event.label);
+        event.type = ONCE;
+
+        return in.offset;
+    }
+
+    MappedEventParser::iterator::iterator(MappedEventParser* parser, size_t offset) : _parser(parser) {
+        _next = _parser->parse(offset, _event);
+    }
+
+    MappedEventParser::iterator& MappedEventParser::iterator::operator++() {
+        _next = _parser->parse(_next, _event);
+        return *this;
+    }
+
+    MappedEventParser::iterator MappedEventParser::iterator::operator++(int) {
+        auto rtn = *this;
+        ++*this;
+        return rtn;
+    }
+
+    MappedEventParser::iterator MappedEventParser::begin() { return {this, 0}; }
+
+    MappedEventParser::iterator MappedEventParser::end() {
+        iterator rtn;
+        rtn._parser = this;
+        return rtn;
+    }
+
+    const LabelTable& MappedEventParser::labels() const { return _labels; }
+
+    ParallelEventParser::ParallelEventParser(const std::string& path, size_t threads, size_t chunk_size) :
+            _file(path, "trace", true), _data(_file.data()), _size(_file.size()), _threads(threads) {
+        split(chunk_size);
+    }
+
+    ParallelEventParser::ParallelEventParser(const char* data, size_t size, size_t threads, size_t chunk_size) :
+            _data(data), _size(size), _threads(threads) {
+        split(chunk_size);
+    }
+
+    ParallelEventParser::~ParallelEventParser() {
+        // The threads refer to the buffer and the alphabet, so they are stopped before the members are destroyed
+        _stop = true;
+        _pending.clear();
+    }
+
+    void ParallelEventParser::split(size_t chunk_size) {
+        if (_threads == 0)
+            _threads = std::max(1u, std::thread::hardware_concurrency());
+        chunk_size = std::max<size_t>(chunk_size, 1);
+
+        // Every '@' starts an event, since labels cannot contain it
+        _boundaries.push_back(0);
+        while (_size - _boundaries.back() > chunk_size) {
+            auto target = _boundaries.back() + chunk_size;
+            auto at = static_cast<const char*>(std::memchr(_data + target, '@', _size - target));
+            if (at == nullptr)
+                break;
+            _boundaries.push_back(at - _data);
+        }
+        _boundaries.push_back(_size);
+    }
+
+    void ParallelEventParser::set_alphabet(PerfectHash alphabet) {
+        _alphabet = std::move(alphabet);
+        _labels.intern("");
+    }
+
+    void ParallelEventParser::set_sessions(bool sessions) { _sessions = sessions; }
+
+    ParallelEventParser::chunk_t ParallelEventParser::parse_chunk(const char* data, size_t begin, size_t end,
+                                                                  const PerfectHash* alphabet, bool sessions,
+                                                                  const std::atomic<bool>& stop) {
+        chunk_t chunk;
+
+        // The parser sees the buffer up to the end of the chunk, so offsets in errors are offsets into the buffer
+        MappedEventParser parser(data, end);
+        if (alphabet != nullptr)
+            parser.set_alphabet(*alphabet);
+        parser.set_sessions(sessions);
+
+        auto offset = begin;
+        try {
+            event_t event;
+            for (size_t next; (next = parser.parse(offset, event)) != MappedEventParser::npos; offset = next) {
+                chunk.events.push_back(event);
+                if (chunk.events.size() % 4096 == 0 && stop)
+                    break;
+            }
+        } catch (const base_error&) {
+            chunk.error = std::current_exception();
+        }
+
+        // The sequential parser stops at a '\000', so the chunks after it are not delivered
+        while (offset < end && is_space(data[offset]))
+            ++offset;
+        chunk.terminated = chunk.error == nullptr && offset < end;
+        chunk.number_of_labels = parser.labels().size();
+        return chunk;
+    }
+
+    void ParallelEventParser::schedule() {
+        const PerfectHash* alphabet = _alphabet ? &*_alphabet : nullptr;
+        while (_pending.size() < _threads && _scheduled + 1 < _boundaries.size()) {
+            _pending.push_back(std::async(std::launch::async, parse_chunk, _data, _boundaries[_scheduled],
+                                          _boundaries[_scheduled + 1], alphabet, _sessions, std::cref(_stop)));
+            ++_scheduled;
+        }
+    }
+
+    bool ParallelEventParser::next() {
+        while (_position == _chunk.events.size()) {
+            if (_chunk.error) {
+                _chunk.terminated = true;
+                std::rethrow_exception(std::exchange(_chunk.error, nullptr));
+            }
+            if (_chunk.terminated || _pending.empty())
+                return false;
+
+            _chunk = _pending.front().get();
+            _pending.pop_front();
+            _position = 0;
+            schedule();
+
+            // Local ids are mapped to ids in labels() once per distinct label in the chunk
+            constexpr auto unmapped = std::numeric_limits<label_id_t>::max();
+            std::vector<label_id_t> ids(_chunk.number_of_labels, unmapped);
+            for (auto& event : _chunk.events) {
+                auto& id = ids[event.id];
+                if (id == unmapped)
+                    id = _labels.intern(event.label);
+                event.id = id;
+            }
+        }
+
+        _event = _chunk.events[_position++];
+        return true;
+    }
+
+    ParallelEventParser::iterator::iterator(ParallelEventParser* parser) : _parser(parser) {
+        if (not _parser->next())
+            _parser = nullptr;
+    }
+
+    ParallelEventParser::iterator& ParallelEventParser::iterator::operator++() {
+        if (not _parser->next())
+            _parser = nullptr;
+        return *this;
+    }
+
+    ParallelEventParser::iterator ParallelEventParser::begin() {
+        schedule();
+        return iterator(this);
+    }
+
+    ParallelEventParser::iterator ParallelEventParser::end() { return {}; }
+
+    size_t ParallelEventParser::number_of_chunks() const { return _boundaries.size() - 1; }
+
+    const LabelTable& ParallelEventParser::labels() const { return _labels; }
+}
@@ -25,10 +25,21 @@
 
 #include "TA.h"
 #include "Monitor.h"
+#include "LabelTable.h"
+#include "MappedFile.h"
+#include "PerfectHash.h"
 #include "types.h"
 #include "errors.h"
 
+#include <atomic>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <future>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
 
 
 /** EVENT PARSER
@@ -48,6 +59,7 @@
  *                 | EventList Event
  *
  *      Event := '@' Time Label
+ *             | '@' Time Session Label
  *
  *      Time := Interval
  *            | ConcreteTime
@@ -57,6 +69,11 @@
  *      ConcreteTime := DECIMAL
  *
  *      Label := * A string that does not include whitespace or '@' *
+ *
+ *      Session := '#' Label
+ *
+ *  The session key is only read by the StreamEventParser, the MappedEventParser and the ParallelEventParser,
+ *  into event_t::session, and only if set_sessions(true) is called. Otherwise '#' is an ordinary character of labels.
  */
 
 namespace monitaal {
@@ -66,6 +83,271 @@ public:
         static std::vector<timed_input_t> parse_input(std::istream* stream, uint32_t limit);
     };
 
+    /**
+     * Parses one event at a time from a stream, e.g. standard input, such that parsing and monitoring is one pass in
+     * constant memory. Events are produced by an input iterator, i.e. an event is parsed when the iterator is
+     * advanced. The label of an event is a view of the label interned in labels() and stays valid.
+     */
+    class StreamEventParser {
+        std::istream& _stream;
+
+        std::string _label; // Reused buffer for the label being read
+        std::string _session; // Reused buffer for the session key, the session of an event is valid until next()
+
+        LabelTable _labels;
+
+        std::optional<PerfectHash> _alphabet;
+        label_id_t _unobserved = 0;
+        bool _sessions = false;
+
+        event_t _event;
+
+        // Parses the next event into _event. Returns false if there are no more events
+        bool next();
+
+    public:
+        class iterator {
+            friend class StreamEventParser;
+
+            StreamEventParser* _parser = nullptr; // nullptr when there are no more events
+
+            explicit iterator(StreamEventParser* parser);
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _parser->_event; }
+            pointer operator->() const { return &_parser->_event; }
+
+            iterator& operator++();
+            void operator++(int) { ++*this; }
+
+            bool operator==(const iterator& other) const { return _parser == other._parser; }
+        };
+
+        explicit StreamEventParser(std::istream& stream);
+
+        StreamEventParser(const StreamEventParser&) = delete;
+        StreamEventParser& operator=(const StreamEventParser&) = delete;
+
+        /**
+         * Labels outside the alphabet are replaced by the empty label (only the time of the event is kept)
+         * and are never interned.
+         */
+        void set_alphabet(PerfectHash alphabet);
+
+        // Reads a '#' token before the label as the session key of the event
+        void set_sessions(bool sessions);
+
+        iterator begin();
+        iterator end();
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+
+    /**
+     * Parses the grammar above directly from a buffer, e.g. a memory mapped trace file.
+     *
+     * Events are produced lazily by a forward iterator. The label of an event is a view into the buffer and its id
+     * is interned in labels(), so no memory is allocated per event (only once per distinct label).
+     * Time points are integers. Errors are reported as base_error with the byte offset into the buffer.
+     */
+    class MappedEventParser {
+        friend class ParallelEventParser;
+
+        MappedFile _file;
+
+        const char* _data;
+        size_t _size;
+
+        LabelTable _labels;
+
+        std::optional<PerfectHash> _alphabet;
+        label_id_t _unobserved = 0;
+        bool _sessions = false;
+
+        // Parses the first event at or after offset (after whitespace). Returns the offset after the event,
+        // or npos if there are no more events.
+        size_t parse(size_t offset, event_t& event);
+
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        class iterator {
+            friend class MappedEventParser;
+
+            MappedEventParser* _parser = nullptr;
+            size_t _next = npos;
+            event_t _event;
+
+            iterator(MappedEventParser* parser, size_t offset);
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _event; }
+            pointer operator->() const { return &_event; }
+
+            iterator& operator++();
+            iterator operator++(int);
+
+            bool operator==(const iterator& other) const { return _next == other._next; }
+        };
+
+        /**
+         * Maps the file read-only. The mapping lives as long as the parser.
+         * Throws base_error if the file cannot be mapped.
+         */
+        explicit MappedEventParser(const std::string& path);
+
+        /**
+         * Parses a buffer owned by the caller. The buffer must outlive the parser and its events.
+         */
+        MappedEventParser(const char* data, size_t size);
+
+        MappedEventParser(const MappedEventParser&) = delete;
+        MappedEventParser& operator=(const MappedEventParser&) = delete;
+
+        /**
+         * Prefilter: the label bytes in the buffer are looked up in the perfect hash of the alphabet. Labels outside
+         * the alphabet are replaced by the empty label (only the time of the event is kept) and are never interned.
+         */
+        void set_alphabet(PerfectHash alphabet);
+
+        // Reads a '#' token before the label as the session key of the event
+        void set_sessions(bool sessions);
+
+        iterator begin();
+        iterator end();
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+
+    /**
+     * Parses a buffer, e.g. a memory mapped multi-GB trace file, with several threads. The buffer is split into
+     * chunks at '@' separators and each chunk is parsed by a MappedEventParser over the same buffer into its own
+     * event buffer, so errors keep their byte offset into the whole buffer.
+     *
+     * Chunks are delivered in order by an input iterator, and at most one chunk per thread is parsed ahead.
+     * Labels are views into the buffer and ids are interned in labels() as chunks are delivered.
+     * A parse error is thrown when the iterator reaches it, i.e. after the events before it are delivered.
+     */
+    class ParallelEventParser {
+        struct chunk_t {
+            std::vector<event_t> events; // Ids are local to the chunk
+            size_t number_of_labels = 0; // Number of local ids
+            bool terminated = false;     // The chunk ends at a '\0' before its end, so it is the last chunk
+            std::exception_ptr error;
+        };
+
+        MappedFile _file;
+
+        const char* _data;
+        size_t _size;
+
+        std::vector<size_t> _boundaries; // Chunk i is [_boundaries[i], _boundaries[i + 1])
+        size_t _scheduled = 0;           // Number of chunks handed to a thread
+        size_t _threads;
+
+        std::optional<PerfectHash> _alphabet;
+        bool _sessions = false;
+        std::atomic<bool> _stop = false;
+
+        std::deque<std::future<chunk_t>> _pending;
+        chunk_t _chunk;
+        size_t _position = 0;
+
+        LabelTable _labels;
+
+        event_t _event;
+
+        static chunk_t parse_chunk(const char* data, size_t begin, size_t end, const PerfectHash* alphabet,
+                                   bool sessions, const std::atomic<bool>& stop);
+
+        void split(size_t chunk_size);
+
+        void schedule();
+
+        // Moves the next event into _event. Returns false if there are no more events
+        bool next();
+
+    public:
+        static constexpr size_t default_chunk_size = 4 << 20;
+
+        class iterator {
+            friend class ParallelEventParser;
+
+            ParallelEventParser* _parser = nullptr; // nullptr when there are no more events
+
+            explicit iterator(ParallelEventParser* parser);
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _parser->_event; }
+            pointer operator->() const { return &_parser->_event; }
+
+            iterator& operator++();
+            void operator++(int) { ++*this; }
+
+            bool operator==(const iterator& other) const { return _parser == other._parser; }
+        };
+
+        /**
+         * Maps the file read-only. The mapping lives as long as the parser.
+         * threads = 0 uses one thread per hardware thread.
+         * Throws base_error if the file cannot be mapped.
+         */
+        explicit ParallelEventParser(const std::string& path, size_t threads = 0,
+                                     size_t chunk_size = default_chunk_size);
+
+        /**
+         * Parses a buffer owned by the caller. The buffer must outlive the parser and its events.
+         */
+        ParallelEventParser(const char* data, size_t size, size_t threads = 0,
+                            size_t chunk_size = default_chunk_size);
+
+        // Waits for the chunks that are being parsed
+        ~ParallelEventParser();
+
+        ParallelEventParser(const ParallelEventParser&) = delete;
+        ParallelEventParser& operator=(const ParallelEventParser&) = delete;
+
+        /**
+         * As MappedEventParser::set_alphabet. Must be called before begin().
+         */
+        void set_alphabet(PerfectHash alphabet);
+
+        // As MappedEventParser::set_sessions. Must be called before begin()
+        void set_sessions(bool sessions);
+
+        // Starts parsing. Can only be called once
+        iterator begin();
+        iterator end();
+
+        [[nodiscard]] size_t number_of_chunks() const;
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+
 }
 
 #endif //MONITAAL_EVENT_PARSER_H
@@ -24,6 +24,8 @@
 #include "types.h"
 #include "state.h"
 
+#include <optional>
+
 namespace monitaal {
 
     template<class state_t>
@@ -74,37 +76,119 @@ namespace monitaal {
     }
 
     template<class state_t>
-    symbolic_state_map_t<state_t> Fixpoint<state_t>::buchi_accept_fixpoint(const TA &T) {
-        auto reach_a = reach(accept_states(T), T);
+    symbolic_state_map_t<state_t> Fixpoint<state_t>::accept_states(const TA &T, uint32_t set) {
+        symbolic_state_map_t<state_t> accept_states;
 
+        for (const auto& [_, loc] : T.locations()) {
+            if (loc.is_accept(set))
+                accept_states.insert(state_t::unconstrained(loc.id(), T.number_of_clocks()));
+        }
 
-        std::vector<location_id_t> erase_list{};
-        // Remove states in all locations that are not accept. This is the same as intersecting with accept states
-        for (const auto &[l,_] : reach_a)
-            if (not T.locations().at(l).is_accept())
-                erase_list.push_back(l);
+        return accept_states;
+    }
 
-        for (const auto &l : erase_list)
-            reach_a.remove(l);
-        erase_list.clear();
+    template<class state_t>
+    symbolic_state_map_t<state_t> Fixpoint<state_t>::buchi_accept_fixpoint(const TA &T, bool time_divergence) {
+        // Generalized Büchi acceptance as the greatest fixpoint of
+        // Z = reach(F_0 & reach(F_1 & ... reach(F_n & Z))), i.e. the acceptance sets are visited in turn.
+        // This only removes locations between the reach computations, so no federations are intersected.
+        // With a single acceptance set this is the usual Büchi fixpoint.
+        //
+        // For time divergence, a clock z that is never reset by the automaton is added, and a round through
+        // the acceptance sets only ends when z >= 1, after which z is reset. So each round takes at least one
+        // time unit. Whether time can diverge does not depend on the value of z, hence the clock is removed
+        // again from the result.
+        const TA* A = &T;
+        std::optional<TA> extended;
+        const clock_index_t z = T.number_of_clocks();
+
+        if (time_divergence) {
+            clock_map_t clocks;
+            for (clock_index_t i = 0; i < T.number_of_clocks(); ++i)
+                clocks.insert({i, T.clock_name(i)});
+            clocks.insert({z, "div_clock"});
+
+            locations_t locations;
+            edges_t edges;
+            for (const auto& [id, loc] : T.locations()) {
+                locations.push_back(loc);
+                for (const auto& e : T.edges_from(id))
+                    edges.push_back(e);
+            }
 
-        auto reach_b = reach(reach_a, T);
+            extended.emplace("time_divergence", clocks, locations, edges, T.initial_location(), T.number_of_accept_sets());
+            A = &*extended;
+        }
 
-        while (not reach_a.equals(reach_b)) {
-            reach_a = reach_b;
+        const uint32_t last = A->number_of_accept_sets() - 1;
+        std::vector<location_id_t> erase_list{};
 
-            for (const auto &[l,_] : reach_b)
-                if (not T.locations().at(l).is_accept())
+        // Remove states in all locations that are not in the acceptance set.
+        // This is the same as intersecting with accept states
+        auto restrict_to_set = [A, &erase_list](symbolic_state_map_t<state_t>& states, uint32_t set) {
+            for (const auto &[l,_] : states)
+                if (not A->locations().at(l).is_accept(set))
                     erase_list.push_back(l);
 
             for (const auto &l : erase_list)
-                reach_b.remove(l);
+                states.remove(l);
             erase_list.clear();
+        };
+
+        // Backwards over a divergence tick: z >= 1 at some point before the next transition, after which z is reset
+        auto tick = [time_divergence, z](symbolic_state_map_t<state_t>& states) {
+            if (not time_divergence) return;
+
+            symbolic_state_map_t<state_t> rtn;
+            for (auto [_, s] : states) {
+                s.down();
+                s.restrict_to_zero({z});
+                s.free({z});
+                s.restrict({constraint_t::lower_non_strict(z, 1)});
+                rtn.insert(s);
+            }
+            states = std::move(rtn);
+        };
+
+        auto chain = [A, &restrict_to_set, last](symbolic_state_map_t<state_t> states) {
+            for (uint32_t set = last; set > 0; --set) {
+                states = reach(states, *A);
+                restrict_to_set(states, set - 1);
+            }
+            return reach(states, *A);
+        };
+
+        auto start = accept_states(*A, last);
+        tick(start);
+        auto reach_a = chain(std::move(start));
+
+        while (true) {
+            auto reach_b = reach_a;
+            tick(reach_b);
+            restrict_to_set(reach_b, last);
+            reach_b = chain(std::move(reach_b));
+
+            if (reach_a.equals(reach_b))
+                break;
+
+            reach_a = std::move(reach_b);
+        }
+
+        if (not time_divergence)
+            return reach_a;
+
+        symbolic_state_map_t<state_t> rtn;
+        for (auto [l, s] : reach_a) {
+            s.restrict_to_zero({z});
+            s.remove_clock(z);
 
-            reach_b = reach(reach_b, T);
+            // Rebuild the state in the dimensions of T, such that clocks of the state itself are indexed correctly
+            auto state = state_t::unconstrained(l, T.number_of_clocks());
+            state.intersection(s);
+            rtn.insert(state);
         }
 
-        return reach_a;
+        return rtn;
     }
 
     template class Fixpoint<symbolic_state_t>;
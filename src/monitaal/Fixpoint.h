@@ -47,12 +47,23 @@ namespace monitaal {
          */
         static symbolic_state_map_t<state_t> accept_states(const TA& T);
 
+        /**
+         * Fetches all the states (symbolic) that are in locations of the given acceptance set.
+         * @param T: The Timed Automaton.
+         * @param set: Index of the acceptance set.
+         * @return A set of symbolic states encapsulating the states of the acceptance set.
+         */
+        static symbolic_state_map_t<state_t> accept_states(const TA& T, uint32_t set);
+
         /**
          * Calculates the set of states that can infinitely often reach an accepting state.
+         * For generalized Büchi automata, every acceptance set must be reached infinitely often.
          * @param T: The Timed Automaton.
+         * @param time_divergence: Only consider runs where time diverges. This is checked with an extra clock
+         * that only exists during the fixpoint computation, so the result has the dimensions of T.
          * @return The maximum set of symbolic states that can reach an accepting state infinitely.
          */
-        static symbolic_state_map_t<state_t> buchi_accept_fixpoint(const TA& T);
+        static symbolic_state_map_t<state_t> buchi_accept_fixpoint(const TA& T, bool time_divergence = false);
 
         /**
          * Calculates the set of states that can be reached at a given time point
@@ -0,0 +1,53 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LabelTable.h"
+#include "errors.h"
+
+namespace monitaal {
+
+    label_id_t LabelTable::intern(std::string_view label) {
+        auto it = _ids.find(label);
+        if (it != _ids.end())
+            return it->second;
+
+        auto id = static_cast<label_id_t>(_labels.size());
+        const auto& stored = _labels.emplace_back(label);
+        _ids.insert({std::string_view(stored), id});
+        return id;
+    }
+
+    std::optional<label_id_t> LabelTable::find(std::string_view label) const {
+        auto it = _ids.find(label);
+        if (it == _ids.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    const label_t& LabelTable::label(label_id_t id) const {
+        if (id >= _labels.size())
+            throw base_error("Error: Unknown label id ", id);
+        return _labels[id];
+    }
+
+    size_t LabelTable::size() const { return _labels.size(); }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MONITAAL_LABEL_TABLE_H
+#define MONITAAL_LABEL_TABLE_H
+
+#include "types.h"
+
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace monitaal {
+
+    /**
+     * Interns labels as dense ids (0, 1, 2, ...) in order of first occurrence.
+     * Only the first occurrence of a label allocates. References to interned labels stay valid.
+     */
+    class LabelTable {
+        std::deque<label_t> _labels;
+
+        // The keys are views into _labels
+        std::unordered_map<std::string_view, label_id_t> _ids;
+
+    public:
+        label_id_t intern(std::string_view label);
+
+        [[nodiscard]] std::optional<label_id_t> find(std::string_view label) const;
+
+        [[nodiscard]] const label_t& label(label_id_t id) const;
+
+        [[nodiscard]] size_t size() const;
+    };
+}
+
+#endif //MONITAAL_LABEL_TABLE_H
@@ -0,0 +1,160 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_MPSC_RING_H
+#define MONITAAL_MPSC_RING_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+namespace monitaal {
+
+    /**
+     * Bounded queue for any number of producer threads and one consumer thread (D. Vyukov's bounded queue).
+     *
+     * Each cell has a sequence number that tells whether it is free for the producer of a given position or filled
+     * for the consumer. A producer claims a position with one compare-and-swap and publishes its value with a release
+     * store, and producers never wait for each other unless the ring is full. The consumer takes no atomic
+     * read-modify-write. A value is only visible to the consumer once its producer has published it, so a producer
+     * preempted between claiming and publishing delays the values behind it.
+     *
+     * The blocking push and pop wait like those of SPSCRing. close() should be called when the producers are done:
+     * a value pushed concurrently with close may not be delivered.
+     */
+    template<class T>
+    class MPSCRing {
+        static constexpr size_t cache_line = 64;
+
+        struct cell_t {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        const size_t _capacity, _mask;
+        std::unique_ptr<cell_t[]> _cells;
+
+        // Written by the consumer
+        alignas(cache_line) size_t _head = 0;
+
+        // Written by the producers
+        alignas(cache_line) std::atomic<size_t> _tail{0};
+
+        alignas(cache_line) std::atomic<bool> _closed{false};
+
+        static void backoff(unsigned& spins) {
+            static const unsigned spin_limit = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+            if (++spins > spin_limit)
+                std::this_thread::yield();
+        }
+
+    public:
+        /**
+         * The capacity is rounded up to a power of two.
+         */
+        explicit MPSCRing(size_t capacity) :
+                _capacity(std::bit_ceil(capacity < 2 ? size_t(2) : capacity)), _mask(_capacity - 1),
+                _cells(new cell_t[_capacity]) {
+            for (size_t i = 0; i < _capacity; ++i)
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MPSCRing(const MPSCRing&) = delete;
+        MPSCRing& operator=(const MPSCRing&) = delete;
+
+        [[nodiscard]] size_t capacity() const { return _capacity; }
+
+        // Any thread. Returns false if the ring is full or closed
+        bool try_push(const T& value) {
+            if (closed())
+                return false;
+
+            auto tail = _tail.load(std::memory_order_relaxed);
+            cell_t* cell;
+            while (true) {
+                cell = &_cells[tail & _mask];
+                auto sequence = cell->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - tail);
+
+                if (difference == 0) { // The cell is free for position tail
+                    if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                        break;
+                } else if (difference < 0) // The cell still holds the value of the previous round
+                    return false;
+                else // Another producer claimed position tail
+                    tail = _tail.load(std::memory_order_relaxed);
+            }
+
+            cell->value = value;
+            cell->sequence.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only
+        bool try_pop(T& value) {
+            cell_t& cell = _cells[_head & _mask];
+            if (cell.sequence.load(std::memory_order_acquire) != _head + 1)
+                return false;
+
+            value = cell.value;
+            cell.sequence.store(_head + _capacity, std::memory_order_release);
+            ++_head;
+            return true;
+        }
+
+        /**
+         * Any thread. Waits while the ring is full. Returns false (without pushing) if the ring is closed.
+         */
+        bool push(const T& value) {
+            unsigned spins = 0;
+            while (not try_push(value)) {
+                if (closed())
+                    return false;
+                backoff(spins);
+            }
+            return true;
+        }
+
+        /**
+         * Consumer only. Waits while the ring is empty. Returns false if the ring is closed and empty.
+         */
+        bool pop(T& value) {
+            unsigned spins = 0;
+            while (true) {
+                if (try_pop(value))
+                    return true;
+                if (closed()) // Values pushed before closing are still delivered
+                    return try_pop(value);
+                backoff(spins);
+            }
+        }
+
+        void close() { _closed.store(true, std::memory_order_release); }
+
+        [[nodiscard]] bool closed() const { return _closed.load(std::memory_order_acquire); }
+    };
+}
+
+#endif //MONITAAL_MPSC_RING_H
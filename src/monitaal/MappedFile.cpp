@@ -0,0 +1,66 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "MappedFile.h"
+#include "errors.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <filesystem>
+
+namespace monitaal {
+
+    struct MappedFile::mapping_t {
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
+    };
+
+    MappedFile::MappedFile(const std::string& path, const std::string& what, bool sequential) {
+        using namespace boost::interprocess;
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec)
+            throw base_error("Error: Could not open ", what, " ", path, ": ", ec.message());
+        if (size == 0) // An empty file cannot be mapped
+            return;
+
+        try {
+            auto mapping = std::make_shared<mapping_t>();
+            mapping->file = file_mapping(path.c_str(), read_only);
+            mapping->region = mapped_region(mapping->file, read_only);
+            if (sequential)
+                mapping->region.advise(mapped_region::advice_sequential);
+
+            _data = static_cast<const char*>(mapping->region.get_address());
+            _size = mapping->region.get_size();
+            _mapping = std::move(mapping);
+        } catch (const interprocess_exception& e) {
+            throw base_error("Error: Could not map ", what, " ", path, ": ", e.what());
+        }
+    }
+
+    const char* MappedFile::data() const { return _data; }
+
+    size_t MappedFile::size() const { return _size; }
+}
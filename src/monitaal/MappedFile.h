@@ -0,0 +1,59 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MONITAAL_MAPPED_FILE_H
+#define MONITAAL_MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace monitaal {
+
+    /**
+     * A file mapped read-only into memory. Copies share the mapping, which is unmapped with the last copy.
+     * An empty file is not mapped, data() is then nullptr and size() is 0.
+     */
+    class MappedFile {
+        struct mapping_t;
+
+        std::shared_ptr<const mapping_t> _mapping;
+
+        const char* _data = nullptr;
+        size_t _size = 0;
+
+    public:
+        MappedFile() = default;
+
+        /**
+         * Throws base_error if the file cannot be mapped. what describes the file in the error message.
+         * If sequential is set, the kernel is advised that the file is read from start to end.
+         */
+        explicit MappedFile(const std::string& path, const std::string& what = "file", bool sequential = false);
+
+        [[nodiscard]] const char* data() const;
+
+        [[nodiscard]] size_t size() const;
+    };
+}
+
+#endif //MONITAAL_MAPPED_FILE_H
@@ -0,0 +1,271 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ModelArtifact.h"
+#include "Fixpoint.h"
+#include "MappedFile.h"
+#include "BinaryIO.h"
+#include "errors.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace monitaal {
+
+    namespace {
+        constexpr char magic[4] = {'M', 'T', 'A', 'L'};
+
+        struct writer_t : binary_writer_t {
+            void automaton(const TA& T, const symbolic_state_map_t<symbolic_state_t>& space) {
+                string(T.name());
+
+                u32(T.number_of_clocks());
+                for (clock_index_t i = 0; i < T.number_of_clocks(); ++i)
+                    string(T.clock_name(i));
+
+                u32(T.number_of_accept_sets());
+                u32(T.initial_location());
+
+                u32(T.locations().size());
+                for (const auto& [id, loc] : T.locations()) {
+                    raw<uint64_t>(loc.accept_sets());
+                    u32(id);
+                    string(loc.name());
+                    constraints(loc.invariant());
+                }
+
+                size_t edges = 0;
+                for (const auto& [id, _] : T.locations())
+                    edges += T.edges_from(id).size();
+                u32(edges);
+                for (const auto& [id, _] : T.locations())
+                    for (const auto& e : T.edges_from(id)) {
+                        u32(e.from());
+                        u32(e.to());
+                        string(e.label());
+                        constraints(e.guard());
+                        u32(e.reset().size());
+                        for (const auto& r : e.reset())
+                            u32(r);
+                    }
+
+                u32(T.labels().size());
+                for (const auto& l : T.labels())
+                    string(l);
+
+                const auto& inactive = T.inactive_clocks();
+                u32(inactive.size());
+                for (const auto& [l, clocks] : inactive) {
+                    u32(l);
+                    u32(clocks.size());
+                    for (const auto& x : clocks)
+                        u32(x);
+                }
+
+                u32(space.size());
+                for (const auto& [l, s] : space) {
+                    const auto federation = s.federation();
+                    u32(l);
+                    u32(federation.dimension());
+                    u32(federation.size());
+                    for (const auto& z : federation)
+                        zone(z);
+                }
+            }
+        };
+
+        struct reader_t : binary_reader_t {
+            std::pair<TA, symbolic_state_map_t<symbolic_state_t>> automaton() {
+                auto name = string();
+
+                clock_map_t clocks;
+                auto number_of_clocks = u32();
+                need(number_of_clocks, 4);
+                for (clock_index_t i = 0; i < number_of_clocks; ++i)
+                    clocks.insert({i, string()});
+
+                auto accept_sets = u32();
+                auto initial = u32();
+
+                locations_t locations;
+                auto number_of_locations = u32();
+                need(number_of_locations, 20);
+                for (uint32_t k = 0; k < number_of_locations; ++k) {
+                    auto accept = raw<uint64_t>();
+                    auto id = u32();
+                    auto loc_name = string();
+                    locations.push_back(location_t(accept, id, loc_name, constraints(number_of_clocks)));
+                }
+
+                edges_t edges;
+                auto number_of_edges = u32();
+                need(number_of_edges, 20);
+                for (uint32_t k = 0; k < number_of_edges; ++k) {
+                    auto from = u32(), to = u32();
+                    auto label = string();
+                    auto guard = constraints(number_of_clocks);
+                    clocks_t reset;
+                    auto resets = u32();
+                    need(resets, 4);
+                    for (uint32_t r = 0; r < resets; ++r)
+                        reset.push_back(clock(number_of_clocks));
+                    edges.push_back(edge_t(from, to, guard, reset, label));
+                }
+
+                label_set_t labels;
+                auto number_of_labels = u32();
+                need(number_of_labels, 4);
+                for (uint32_t k = 0; k < number_of_labels; ++k)
+                    labels.insert(string());
+
+                std::map<location_id_t, std::vector<clock_index_t>> inactive;
+                auto number_of_inactive = u32();
+                need(number_of_inactive, 8);
+                for (uint32_t k = 0; k < number_of_inactive; ++k) {
+                    auto l = u32();
+                    auto number_of_inactive_clocks = u32();
+                    need(number_of_inactive_clocks, 4);
+                    std::vector<clock_index_t> inactive_clocks(number_of_inactive_clocks);
+                    for (auto& x : inactive_clocks)
+                        x = clock(number_of_clocks);
+                    inactive.insert({l, std::move(inactive_clocks)});
+                }
+
+                std::unordered_set<location_id_t> ids;
+                for (const auto& loc : locations)
+                    ids.insert(loc.id());
+                if (not ids.contains(initial) || std::any_of(edges.begin(), edges.end(), [&ids](const edge_t& e) {
+                        return not ids.contains(e.from()) || not ids.contains(e.to()); }))
+                    throw base_error("Error: Model artifact refers to an unknown location in ", name);
+
+                TA T(name, clocks, locations, edges, initial, accept_sets, labels, std::move(inactive));
+
+                symbolic_state_map_t<symbolic_state_t> space;
+                auto number_of_states = u32();
+                need(number_of_states, 12);
+                for (uint32_t k = 0; k < number_of_states; ++k) {
+                    auto l = u32();
+                    auto dimension = u32();
+                    auto zones = u32();
+
+                    if (not T.locations().contains(l) || dimension != T.number_of_clocks() + 1)
+                        throw base_error("Error: Model artifact has an accepting space that does not match ",
+                                         T.name(), " at byte ", offset);
+                    need(zones, 5 * dimension * dimension);
+
+                    for (uint32_t z = 0; z < zones; ++z) {
+                        auto zone = this->zone(dimension);
+
+                        auto state = symbolic_state_t::unconstrained(l, T.number_of_clocks());
+                        state.restrict(zone);
+                        space.insert(state);
+                    }
+                }
+
+                return {std::move(T), std::move(space)};
+            }
+        };
+    }
+
+    ModelArtifact::ModelArtifact(TA positive, TA negative, symbolic_state_map_t<symbolic_state_t> positive_space,
+                                 symbolic_state_map_t<symbolic_state_t> negative_space, bool time_divergence) :
+            _positive(std::make_shared<const CompiledProperty<symbolic_state_t>>(
+                    std::move(positive), std::move(positive_space), time_divergence)),
+            _negative(std::make_shared<const CompiledProperty<symbolic_state_t>>(
+                    std::move(negative), std::move(negative_space), time_divergence)),
+            _time_divergence(time_divergence) {}
+
+    ModelArtifact::ModelArtifact(TA positive, TA negative, bool time_divergence) :
+            _positive(CompiledProperty<symbolic_state_t>::compile(std::move(positive), time_divergence)),
+            _negative(CompiledProperty<symbolic_state_t>::compile(std::move(negative), time_divergence)),
+            _time_divergence(time_divergence) {}
+
+    ModelArtifact ModelArtifact::load(const std::string& path) {
+        MappedFile file(path, "model artifact");
+        return decode(file.data(), file.size());
+    }
+
+    ModelArtifact ModelArtifact::decode(const char* data, size_t size) {
+        reader_t in{{data, size, 0, "Model artifact"}};
+
+        in.need(sizeof(magic));
+        if (std::memcmp(data, magic, sizeof(magic)) != 0)
+            throw base_error("Error: Not a MoniTAal model artifact");
+        in.offset += sizeof(magic);
+
+        auto artifact_version = in.u32();
+        if (artifact_version != version)
+            throw base_error("Error: Model artifact has version ", artifact_version, " but version ", version,
+                             " is expected. Compile the model again");
+
+        auto flags = in.u32();
+
+        auto [positive, positive_space] = in.automaton();
+        auto [negative, negative_space] = in.automaton();
+
+        if (in.offset != in.size)
+            throw base_error("Error: Model artifact has trailing data at byte ", in.offset);
+
+        return {std::move(positive), std::move(negative), std::move(positive_space), std::move(negative_space),
+                (flags & 1) != 0};
+    }
+
+    void ModelArtifact::write(std::ostream& out) const {
+        writer_t w{{out}};
+
+        out.write(magic, sizeof(magic));
+        w.u32(version);
+        w.u32(_time_divergence ? 1 : 0);
+
+        w.automaton(_positive->automaton(), _positive->accepting_space());
+        w.automaton(_negative->automaton(), _negative->accepting_space());
+    }
+
+    void ModelArtifact::write(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (not out)
+            throw base_error("Error: Could not open ", path, " for writing");
+
+        write(out);
+
+        if (not out)
+            throw base_error("Error: Could not write model artifact to ", path);
+    }
+
+    const TA& ModelArtifact::positive() const { return _positive->automaton(); }
+    const TA& ModelArtifact::negative() const { return _negative->automaton(); }
+
+    const symbolic_state_map_t<symbolic_state_t>& ModelArtifact::positive_accepting_space() const {
+        return _positive->accepting_space();
+    }
+
+    const symbolic_state_map_t<symbolic_state_t>& ModelArtifact::negative_accepting_space() const {
+        return _negative->accepting_space();
+    }
+
+    const property_ptr_t<symbolic_state_t>& ModelArtifact::positive_property() const { return _positive; }
+    const property_ptr_t<symbolic_state_t>& ModelArtifact::negative_property() const { return _negative; }
+
+    bool ModelArtifact::time_divergence() const { return _time_divergence; }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MONITAAL_MODEL_ARTIFACT_H
+#define MONITAAL_MODEL_ARTIFACT_H
+
+#include "TA.h"
+#include "CompiledProperty.h"
+#include "state.h"
+#include "types.h"
+
+#include <ostream>
+#include <string>
+
+/** MODEL ARTIFACT
+ *  A compiled property: the positive and negative automata (after trimming) together with their inactive clocks,
+ *  full alphabets and precomputed accepting spaces. Loading an artifact skips XML parsing and the fixpoint.
+ *
+ *  Binary layout (little endian, fixed width integers):
+ *
+ *      Artifact := "MTAL" VERSION:u32 FLAGS:u32 Automaton(positive) Automaton(negative)
+ *
+ *      Automaton := String(name) u32 String* (clock names)
+ *                   ACCEPT_SETS:u32 INITIAL:u32
+ *                   u32 Location*   Location := ACCEPT:u64 ID:u32 String(name) Constraints(invariant)
+ *                   u32 Edge*       Edge := FROM:u32 TO:u32 String(label) Constraints(guard) u32 u32* (reset)
+ *                   u32 String*     (alphabet)
+ *                   u32 Inactive*   Inactive := LOCATION:u32 u32 u32* (clocks)
+ *                   u32 Space*      Space := LOCATION:u32 DIMENSION:u32 u32 Zone*   Zone := Bound^(DIMENSION^2)
+ *
+ *      Constraints := u32 (I:u32 J:u32 Bound)*
+ *      Bound := VALUE:i32 KIND:u8   (0 = non strict, 1 = strict, 2 = infinity)
+ *      String := u32 BYTES
+ *
+ *  FLAGS bit 0 is set if the accepting spaces only consider time divergent runs.
+ *  The accepting spaces are over symbolic_state_t, i.e. the clocks of the automaton and the global clock.
+ */
+
+namespace monitaal {
+
+    class ModelArtifact {
+        property_ptr_t<symbolic_state_t> _positive, _negative;
+
+        bool _time_divergence;
+
+        ModelArtifact(TA positive, TA negative, symbolic_state_map_t<symbolic_state_t> positive_space,
+                      symbolic_state_map_t<symbolic_state_t> negative_space, bool time_divergence);
+
+    public:
+        static constexpr uint32_t version = 1;
+
+        /**
+         * Compiles a property, i.e. computes the accepting spaces of both automata.
+         * @param positive: The automaton of the property.
+         * @param negative: The automaton of the negated property.
+         * @param time_divergence: Only consider time divergent runs.
+         */
+        ModelArtifact(TA positive, TA negative, bool time_divergence);
+
+        /**
+         * Maps the file read-only and decodes the artifact from the mapped memory.
+         * Throws base_error if the file is not a valid artifact of this version.
+         */
+        static ModelArtifact load(const std::string& path);
+
+        /**
+         * Decodes an artifact from a buffer. Throws base_error if the buffer is not a valid artifact of this version.
+         */
+        static ModelArtifact decode(const char* data, size_t size);
+
+        void write(std::ostream& out) const;
+
+        void write(const std::string& path) const;
+
+        [[nodiscard]] const TA& positive() const;
+        [[nodiscard]] const TA& negative() const;
+
+        [[nodiscard]] const symbolic_state_map_t<symbolic_state_t>& positive_accepting_space() const;
+        [[nodiscard]] const symbolic_state_map_t<symbolic_state_t>& negative_accepting_space() const;
+
+        /**
+         * The compiled automata. Interval and concrete monitors of the artifact share them instead of copying.
+         */
+        [[nodiscard]] const property_ptr_t<symbolic_state_t>& positive_property() const;
+        [[nodiscard]] const property_ptr_t<symbolic_state_t>& negative_property() const;
+
+        [[nodiscard]] bool time_divergence() const;
+    };
+}
+
+#endif //MONITAAL_MODEL_ARTIFACT_H
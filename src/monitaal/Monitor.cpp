@@ -21,13 +21,18 @@
  */
 
 #include "Monitor.h"
+#include "BinaryIO.h"
+#include "MappedFile.h"
 #include "errors.h"
 
 #include <utility>
+#include <atomic>
 #include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
 #include <type_traits>
 #include <cassert>
-#include <cstring>
 
 namespace monitaal {
 
@@ -36,71 +41,110 @@ namespace monitaal {
     timed_input_t::timed_input_t(symb_time_t time, label_t label, input_type_e type) 
             : time({time, time}), label(std::move(label)), type(type) {}
 
+    template<class state_t>
+    Single_monitor<state_t>::Single_monitor(const TA &automaton, const settings_t& setting) :
+    Single_monitor(CompiledProperty<space_state_t>::compile(automaton, setting.time_divergence), setting) {}
+
+    template<class state_t>
+    Single_monitor<state_t>::Single_monitor(const TA &automaton, symbolic_state_map_t<space_state_t> accepting_space,
+                                            const settings_t& setting) :
+    Single_monitor(std::make_shared<const CompiledProperty<space_state_t>>(automaton, std::move(accepting_space),
+                                                                          setting.time_divergence), setting) {}
+
     template<>
-    Single_monitor<delay_state_t>::Single_monitor(const TA &automaton, const settings_t& setting) :
-    _automaton(automaton), 
-    _accepting_space(Fixpoint<delay_state_t>::buchi_accept_fixpoint(automaton)),
+    Single_monitor<delay_state_t>::Single_monitor(property_ptr_t<delay_state_t> property, const settings_t& setting) :
+    _property(std::move(property)),
+    _automaton(_property->automaton()),
+    _accepting_space(_property->accepting_space()),
     _inclusion(setting.inclusion),
     _clock_abstraction(setting.clock_abstraction) {
         
         delay_state_t init = delay_state_t(_automaton.initial_location(), _automaton.number_of_clocks(), setting.latency, setting.jitter);
 
-        init.intersection(_accepting_space);
-        if (init.is_empty())
-            _status = OUT;
-        else {
-            _status = ACTIVE;
-            _current_states = std::vector{init};
-        }
+        init_states(std::move(init));
     }
 
     template<>
-    Single_monitor<testing_state_t>::Single_monitor(const TA &automaton, const settings_t& setting) :
-    _automaton(automaton), 
-    _accepting_space(Fixpoint<testing_state_t>::buchi_accept_fixpoint(automaton)),
+    Single_monitor<testing_state_t>::Single_monitor(property_ptr_t<testing_state_t> property, const settings_t& setting) :
+    _property(std::move(property)),
+    _automaton(_property->automaton()),
+    _accepting_space(_property->accepting_space()),
     _inclusion(setting.inclusion),
     _clock_abstraction(setting.clock_abstraction) {
         
         testing_state_t init = testing_state_t(_automaton.initial_location(), _automaton.number_of_clocks(), setting.latency_i, setting.latency, setting.jitter_i, setting.jitter);
 
-        init.intersection(_accepting_space);
-        if (init.is_empty())
-            _status = OUT;
-        else {
-            _status = ACTIVE;
-            _current_states = std::vector{init};
-        }
+        init_states(std::move(init));
     }
 
     template<class state_t>
-    Single_monitor<state_t>::Single_monitor(const TA &automaton, const settings_t& setting) :
-    _automaton(automaton), 
-    _accepting_space(Fixpoint<symbolic_state_t>::buchi_accept_fixpoint(automaton)),
+    Single_monitor<state_t>::Single_monitor(property_ptr_t<space_state_t> property, const settings_t& setting) :
+    _property(std::move(property)),
+    _automaton(_property->automaton()),
+    _accepting_space(_property->accepting_space()),
     _inclusion(setting.inclusion),
     _clock_abstraction(setting.clock_abstraction) {
         
         state_t init = state_t(_automaton.initial_location(), _automaton.number_of_clocks());
 
+        init_states(std::move(init));
+    }
+
+    template<class state_t>
+    void Single_monitor<state_t>::init_states(state_t init) {
         init.intersection(_accepting_space);
-        if (init.is_empty())
+        if (init.is_empty()) {
             _status = OUT;
-        else {
+            _current_states = std::make_shared<std::vector<state_t>>();
+        } else {
             _status = ACTIVE;
-            _current_states = std::vector{init};
+            _current_states = std::make_shared<std::vector<state_t>>(std::vector{init});
         }
+
+        _initial_states = _current_states;
+        _initial_status = _status;
     }
 
+    template<class state_t>
+    std::vector<state_t>& Single_monitor<state_t>::own_states() {
+        if (_current_states.use_count() != 1)
+            _current_states = std::make_shared<std::vector<state_t>>(*_current_states);
+        else // Other owners have released the states, make their last reads visible before writing
+            std::atomic_thread_fence(std::memory_order_acquire);
+        return *_current_states;
+    }
+
+    template<class state_t>
+    void Single_monitor<state_t>::reset(symb_time_t start) {
+        _current_states = _initial_states;
+        _status = _initial_status;
+        _start = start;
+    }
+
+    template<class state_t> const property_ptr_t<typename Single_monitor<state_t>::space_state_t>&
+    Single_monitor<state_t>::property() const { return _property; }
+
     template<class state_t> single_monitor_answer_e
     Single_monitor<state_t>::status() { return _status; }
 
     template<class state_t> single_monitor_answer_e
     Single_monitor<state_t>::input(const timed_input_t& input) {
+        return this->input(event_t{input.time, 0, input.label, input.type});
+    }
+
+    template<class state_t> single_monitor_answer_e
+    Single_monitor<state_t>::input(const event_t& input) {
+
+        if (input.time.first < _start)
+            throw base_error("Error: Input at time ", input.time.first, " is before the monitor was reset at time ", _start);
+        const interval_t time{input.time.first - _start, input.time.second - _start};
 
         std::vector<state_t> next_states;
+        std::vector<state_t>& current_states = own_states();
 
-        if (input.label == "" || not _automaton.labels().contains(input.label)) { // If label is empty, we do not take any transitions, only delay
-            for (auto& s : _current_states) {
-                s.delay(input.time);
+        if (input.label.empty() || not _automaton.label_index(input.label)) { // If label is empty, we do not take any transitions, only delay
+            for (auto& s : current_states) {
+                s.delay(time);
                 if (s.satisfies(_automaton.locations().at(s.location()).invariant())) {
                     s.restrict(_automaton.locations().at(s.location()).invariant());
                     s.intersection(_accepting_space);
@@ -129,8 +173,8 @@ namespace monitaal {
                 }
             }
         } else {
-            for (auto& s : _current_states) {
-                s.delay(input.time);
+            for (auto& s : current_states) {
+                s.delay(time);
                 if (s.satisfies(_automaton.locations().at(s.location()).invariant()))
                     s.restrict(_automaton.locations().at(s.location()).invariant());
                 else
@@ -168,7 +212,7 @@ namespace monitaal {
                 }
                 for (const auto& edge : _automaton.edges_from(s.location())) {
 
-                    if (std::strcmp(edge.label().c_str(), input.label.c_str()) == 0) { //for all edges with input label
+                    if (edge.label() == input.label) { //for all edges with input label
 
                         // If we can do the transition (then do it) and also satisfies the invariant, then explore this
                         if (state.do_transition(edge) && state.satisfies(_automaton.locations()
@@ -212,18 +256,107 @@ namespace monitaal {
         else
             _status = ACTIVE;
 
-        _current_states = next_states;
+        current_states = std::move(next_states);
 
         return _status;
     }
 
-    template<class state_t> std::vector<state_t>
-    Single_monitor<state_t>::state_estimate() { return _current_states; };
+    template<class state_t>
+    void Single_monitor<state_t>::write(binary_writer_t& out) const {
+        out.string(_automaton.name());
+        out.u32(_start);
+        out.raw<uint8_t>(_status);
+
+        out.u32(_current_states->size());
+        for (const auto& s : *_current_states) {
+            out.u32(s.location());
+            if constexpr (std::is_same_v<state_t, concrete_state_t>) {
+                const auto valuation = s.valuation();
+                out.u32(valuation.size());
+                for (const auto& x : valuation)
+                    out.u32(x);
+            } else {
+                const auto federation = s.federation();
+                out.u32(federation.dimension());
+                out.u32(federation.size());
+                for (const auto& zone : federation)
+                    out.zone(zone);
+                if constexpr (std::is_same_v<state_t, testing_state_t>)
+                    out.raw<uint8_t>(s.is_input_mode());
+            }
+        }
+    }
 
     template<class state_t>
-    Monitor<state_t>::Monitor(const TA& pos, const TA& neg)
-            : _monitor_pos(Single_monitor<state_t>(pos, settings_t())), _monitor_neg(Single_monitor<state_t>(neg, settings_t())) {
+    std::tuple<std::vector<state_t>, single_monitor_answer_e, symb_time_t>
+    Single_monitor<state_t>::read(binary_reader_t& in) const {
+        if (in.string() != _automaton.name())
+            throw base_error("Error: Checkpoint is not of the automaton ", _automaton.name());
+
+        symb_time_t start = in.u32();
+        auto status = in.raw<uint8_t>();
+        if (status > OUT)
+            throw base_error("Error: Checkpoint has an invalid status at byte ", in.offset - 1);
+
+        std::vector<state_t> states;
+        auto number_of_states = in.u32();
+
+        for (uint32_t k = 0; k < number_of_states; ++k) {
+            location_id_t location = in.u32();
+            if (not _automaton.locations().contains(location))
+                throw base_error("Error: Checkpoint refers to an unknown location of ", _automaton.name(),
+                                 " at byte ", in.offset - sizeof(uint32_t));
+
+            if constexpr (std::is_same_v<state_t, concrete_state_t>) {
+                valuation_t valuation(in.u32());
+                if (valuation.size() != _automaton.number_of_clocks() + 1)
+                    throw base_error("Error: Checkpoint has a valuation that does not match ", _automaton.name(),
+                                     " at byte ", in.offset);
+                for (auto& x : valuation)
+                    x = in.u32();
+                states.emplace_back(location, std::move(valuation));
+            } else {
+                auto dimension = in.u32();
+                auto zones = in.u32();
+
+                // The initial state has the clocks of the state type, e.g. the latency clocks of delay states
+                if (_initial_states->empty() || dimension != _initial_states->front().federation().dimension() ||
+                    zones == 0)
+                    throw base_error("Error: Checkpoint has a state that does not match ", _automaton.name(),
+                                     " at byte ", in.offset);
+
+                state_t state = _initial_states->front();
+                for (uint32_t z = 0; z < zones; ++z) {
+                    state_t zone = _initial_states->front();
+                    zone.replace(location, Federation::unconstrained(dimension));
+                    zone.restrict(in.zone(dimension));
+                    if (z == 0)
+                        state = std::move(zone);
+                    else
+                        state.add(zone);
+                }
 
+                if constexpr (std::is_same_v<state_t, testing_state_t>) {
+                    if (in.raw<uint8_t>())
+                        state.expect_input();
+                    else
+                        state.expect_output();
+                }
+                states.push_back(std::move(state));
+            }
+        }
+
+        if ((status == OUT) != states.empty())
+            throw base_error("Error: Checkpoint of ", _automaton.name(), " has a status that does not match its states");
+
+        return {std::move(states), static_cast<single_monitor_answer_e>(status), start};
+    }
+
+    template<class state_t> std::vector<state_t>
+    Single_monitor<state_t>::state_estimate() { return *_current_states; };
+
+    template<class state_t>
+    void Monitor<state_t>::init_status() {
         assert((_monitor_pos.status() != OUT || _monitor_neg.status() != OUT) &&
                "Error: Mismatch between positive and negative automata. Both are out\n");
         if (_monitor_pos.status() == OUT)
@@ -232,36 +365,82 @@ namespace monitaal {
             _status = POSITIVE;
         else
             _status = INCONCLUSIVE;
+
+        // Delay and testing states constrain the latency at every observation, so every event counts
+        _coalescable = (std::is_same_v<state_t, symbolic_state_t> || std::is_same_v<state_t, concrete_state_t>) &&
+                       not _monitor_pos._property->has_lower_bound_invariant() &&
+                       not _monitor_neg._property->has_lower_bound_invariant();
+    }
+
+    template<class state_t>
+    Monitor<state_t>::Monitor(const TA& pos, const TA& neg)
+            : _monitor_pos(Single_monitor<state_t>(pos, settings_t())), _monitor_neg(Single_monitor<state_t>(neg, settings_t())) {
+
+        init_status();
     }
 
     template<class state_t>
     Monitor<state_t>::Monitor(const TA& pos, const TA& neg, const settings_t& setting)
             : _monitor_pos(Single_monitor<state_t>(pos, setting)), _monitor_neg(Single_monitor<state_t>(neg, setting)) {
 
-        assert((_monitor_pos.status() != OUT || _monitor_neg.status() != OUT) &&
-               "Error: Mismatch between positive and negative automata. Both are out\n");
-        if (_monitor_pos.status() == OUT)
-            _status = NEGATIVE;
-        else if (_monitor_neg.status() == OUT)
-            _status = POSITIVE;
-        else
-            _status = INCONCLUSIVE;
+        init_status();
+    }
+
+    namespace {
+        template<class space_t>
+        property_ptr_t<space_t> artifact_property(const ModelArtifact& artifact, bool positive) {
+            if constexpr (std::is_same_v<space_t, symbolic_state_t>)
+                return positive ? artifact.positive_property() : artifact.negative_property();
+            else // The artifact holds symbolic states only. Delay and testing states have extra clocks
+                return CompiledProperty<space_t>::compile(positive ? artifact.positive() : artifact.negative(),
+                                                          artifact.time_divergence());
+        }
+    }
+
+    template<class state_t>
+    Monitor<state_t>::Monitor(const ModelArtifact& artifact, const settings_t& setting)
+            : _monitor_pos(artifact_property<typename Single_monitor<state_t>::space_state_t>(artifact, true), setting),
+              _monitor_neg(artifact_property<typename Single_monitor<state_t>::space_state_t>(artifact, false), setting) {
+
+        init_status();
+    }
 
+    template<class state_t>
+    Monitor<state_t>::Monitor(property_ptr_t<typename Single_monitor<state_t>::space_state_t> pos,
+                              property_ptr_t<typename Single_monitor<state_t>::space_state_t> neg,
+                              const settings_t& setting)
+            : _monitor_pos(std::move(pos), setting), _monitor_neg(std::move(neg), setting) {
+
+        init_status();
     }
 
     template<class state_t>
     monitor_answer_e Monitor<state_t>::input(const std::vector<timed_input_t>& input) {
-        for (const auto& i : input) {
-            _status = this->input(i);
-            if (_status != INCONCLUSIVE)
-                break;
+        return this->input(input.begin(), input.end());
+    }
+
+    template<class state_t>
+    monitor_answer_e Monitor<state_t>::input(const timed_input_t& input) {
+        return this->input(event_t{input.time, 0, input.label, input.type});
+    }
+
+    template<class state_t>
+    monitor_answer_e Monitor<state_t>::input(const event_t& input) {
+        const auto previous = _status;
+        const auto event = _events++;
+        step(input);
+
+        if (_status != previous && not _subscribers.empty()) {
+            const verdict_change_t change{_status, event, input.time};
+            for (const auto& [subscription, callback] : _subscribers)
+                callback(change);
         }
 
         return _status;
     }
 
     template<class state_t>
-    monitor_answer_e Monitor<state_t>::input(const timed_input_t& input) {
+    monitor_answer_e Monitor<state_t>::step(const event_t& input) {
         auto pos = _monitor_pos.input(input), neg = _monitor_neg.input(input);
 
         if (pos == OUT && neg == OUT)
@@ -276,11 +455,207 @@ namespace monitaal {
         return _status;
     }
 
+    template<class state_t>
+    size_t Monitor<state_t>::input_run(const std::vector<interval_t>& run) {
+        if (run.size() <= 1) {
+            for (const auto& time : run)
+                input(event_t{time});
+            return run.size();
+        }
+
+        // Delaying to the end of the run is exact, since the accepting space is closed under going back in time.
+        // Saving the states only shares them, input copies them before delaying
+        auto pos_states = _monitor_pos._current_states, neg_states = _monitor_neg._current_states;
+        auto pos_status = _monitor_pos._status, neg_status = _monitor_neg._status;
+
+        if (step(event_t{run.back()}) == INCONCLUSIVE) {
+            _events += run.size();
+            return run.size();
+        }
+
+        // Some event in the run decides the verdict. Monitor the run again to report the same event as without merging
+        _monitor_pos._current_states = std::move(pos_states);
+        _monitor_neg._current_states = std::move(neg_states);
+        _monitor_pos._status = pos_status;
+        _monitor_neg._status = neg_status;
+        _status = INCONCLUSIVE;
+
+        size_t consumed = 0;
+        for (const auto& time : run) {
+            ++consumed;
+            if (input(event_t{time}) != INCONCLUSIVE)
+                break;
+        }
+        return consumed;
+    }
+
+    template<class state_t>
+    monitor_answer_e Monitor<state_t>::reset() {
+        return reset_at(0);
+    }
+
+    template<class state_t>
+    monitor_answer_e Monitor<state_t>::reset_at(symb_time_t time) {
+        _monitor_pos.reset(time);
+        _monitor_neg.reset(time);
+        init_status();
+        _events = 0;
+        return _status;
+    }
+
+    namespace {
+        constexpr char checkpoint_magic[4] = {'M', 'T', 'C', 'P'};
+        constexpr uint32_t checkpoint_version = 1;
+
+        template<class state_t>
+        constexpr uint8_t checkpoint_type() {
+            if constexpr (std::is_same_v<state_t, symbolic_state_t>) return 0;
+            else if constexpr (std::is_same_v<state_t, delay_state_t>) return 1;
+            else if constexpr (std::is_same_v<state_t, concrete_state_t>) return 2;
+            else return 3;
+        }
+    }
+
+    template<class state_t>
+    void Monitor<state_t>::checkpoint(std::ostream& out, uint64_t position) const {
+        binary_writer_t w{out};
+
+        out.write(checkpoint_magic, sizeof(checkpoint_magic));
+        w.u32(checkpoint_version);
+        w.raw<uint8_t>(checkpoint_type<state_t>());
+        w.raw<uint8_t>(_status);
+        w.raw<uint64_t>(position);
+
+        _monitor_pos.write(w);
+        _monitor_neg.write(w);
+    }
+
+    template<class state_t>
+    void Monitor<state_t>::checkpoint(const std::string& path, uint64_t position) const {
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (not out)
+                throw base_error("Error: Could not open ", temporary, " for writing");
+
+            checkpoint(out, position);
+            out.flush();
+
+            if (not out)
+                throw base_error("Error: Could not write checkpoint to ", temporary);
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+            throw base_error("Error: Could not rename ", temporary, " to ", path, ": ", error.message());
+    }
+
+    template<class state_t>
+    uint64_t Monitor<state_t>::restore(const char* data, size_t size) {
+        binary_reader_t in{data, size, 0, "Checkpoint"};
+
+        in.need(sizeof(checkpoint_magic));
+        if (std::memcmp(data, checkpoint_magic, sizeof(checkpoint_magic)) != 0)
+            throw base_error("Error: Not a MoniTAal checkpoint");
+        in.offset += sizeof(checkpoint_magic);
+
+        auto version = in.u32();
+        if (version != checkpoint_version)
+            throw base_error("Error: Checkpoint has version ", version, " but version ", checkpoint_version,
+                             " is expected");
+
+        if (in.raw<uint8_t>() != checkpoint_type<state_t>())
+            throw base_error("Error: Checkpoint is of a monitor with another state type");
+
+        auto verdict = in.raw<uint8_t>();
+        if (verdict > NEGATIVE)
+            throw base_error("Error: Checkpoint has an invalid verdict at byte ", in.offset - 1);
+
+        auto position = in.raw<uint64_t>();
+
+        // Both sides are read before the monitor is changed, such that it is unchanged if the checkpoint is malformed
+        auto [pos_states, pos_status, pos_start] = _monitor_pos.read(in);
+        auto [neg_states, neg_status, neg_start] = _monitor_neg.read(in);
+
+        if (in.offset != in.size)
+            throw base_error("Error: Checkpoint has trailing data at byte ", in.offset);
+
+        _monitor_pos._current_states = std::make_shared<std::vector<state_t>>(std::move(pos_states));
+        _monitor_pos._status = pos_status;
+        _monitor_pos._start = pos_start;
+        _monitor_neg._current_states = std::make_shared<std::vector<state_t>>(std::move(neg_states));
+        _monitor_neg._status = neg_status;
+        _monitor_neg._start = neg_start;
+        _status = static_cast<monitor_answer_e>(verdict);
+        _events = position;
+
+        return position;
+    }
+
+    template<class state_t>
+    uint64_t Monitor<state_t>::restore(const std::string& path) {
+        MappedFile file(path, "checkpoint");
+        return restore(file.data(), file.size());
+    }
+
+    template<class state_t>
+    Monitor<state_t> Monitor<state_t>::fork() const {
+        Monitor fork = *this;
+        fork._subscribers.clear();
+        return fork;
+    }
+
+    template<class state_t>
+    uint64_t Monitor<state_t>::subscribe(verdict_callback_t callback) {
+        _subscribers.emplace_back(_next_subscription, std::move(callback));
+        return _next_subscription++;
+    }
+
+    template<class state_t>
+    void Monitor<state_t>::unsubscribe(uint64_t subscription) {
+        std::erase_if(_subscribers, [subscription](const auto& s) { return s.first == subscription; });
+    }
+
+    template<class state_t>
+    uint64_t Monitor<state_t>::events() const {
+        return _events;
+    }
+
+    template<class state_t>
+    bool Monitor<state_t>::is_observable(std::string_view label) const {
+        return not label.empty() &&
+               (_monitor_pos._automaton.label_index(label) || _monitor_neg._automaton.label_index(label));
+    }
+
     template<class state_t>
     monitor_answer_e Monitor<state_t>::status() const {
         return _status;
     }
 
+    template<class state_t>
+    std::optional<symb_time_t> Monitor<state_t>::deadline() const {
+        if (_status != INCONCLUSIVE)
+            return std::nullopt;
+
+        auto pos = _monitor_pos.deadline(), neg = _monitor_neg.deadline();
+        if (pos && neg)
+            return std::min(*pos, *neg);
+        return pos ? pos : neg;
+    }
+
+    template<class state_t>
+    const property_ptr_t<typename Single_monitor<state_t>::space_state_t>&
+    Monitor<state_t>::positive_property() const {
+        return _monitor_pos.property();
+    }
+
+    template<class state_t>
+    const property_ptr_t<typename Single_monitor<state_t>::space_state_t>&
+    Monitor<state_t>::negative_property() const {
+        return _monitor_neg.property();
+    }
+
     template<class state_t>
     std::vector<state_t>
     Monitor<state_t>::positive_state_estimate() {
@@ -293,9 +668,51 @@ namespace monitaal {
         return _monitor_neg.state_estimate();
     }
 
+    template<class state_t>
+    std::optional<symb_time_t> Single_monitor<state_t>::deadline() const {
+        if constexpr (std::is_same_v<state_t, delay_state_t> || std::is_same_v<state_t, testing_state_t>) {
+            return std::nullopt; // Latency clocks delay the observations, so the global clock is not the input time
+        } else {
+            const clock_index_t global = _automaton.number_of_clocks();
+            std::optional<symb_time_t> latest;
+
+            for (const auto& s : *_current_states) {
+                Federation reachable;
+                if constexpr (std::is_same_v<state_t, concrete_state_t>) {
+                    // The zone of the single valuation
+                    const auto valuation = s.valuation();
+                    reachable = Federation::unconstrained(global + 1);
+                    for (clock_index_t i = 1; i <= global; ++i) {
+                        reachable.restrict(i, 0, pardibaal::bound_t::non_strict(valuation[i]));
+                        reachable.restrict(0, i, pardibaal::bound_t::non_strict(-static_cast<int32_t>(valuation[i])));
+                    }
+                } else
+                    reachable = s.federation();
+
+                // The states reachable by delay that can still be accepted
+                reachable.future();
+                reachable.intersection(_automaton.locations().at(s.location()).invariant_zone(global + 1));
+                if (not _accepting_space.has_state(s.location()))
+                    continue;
+                reachable.intersection(_accepting_space.at(s.location()).federation());
+
+                for (const auto& zone : reachable) {
+                    const auto bound = zone.at(global, 0);
+                    if (bound.is_inf())
+                        return std::nullopt;
+                    // An input at time t delays the global clock to t - _start
+                    symb_time_t first_out = bound.get_bound() + (bound.is_strict() ? 0 : 1) + _start;
+                    latest = latest ? std::max(*latest, first_out) : first_out;
+                }
+            }
+
+            return latest;
+        }
+    }
+
     template<class state_t>
     void Single_monitor<state_t>::print_status(std::ostream& out) const {
-        out << "Number of states: " << _current_states.size() << '\n';
+        out << "Number of states: " << _current_states->size() << '\n';
     }
 
     template<>
@@ -305,7 +722,7 @@ namespace monitaal {
 
         auto latencies = boost::icl::interval_set<symb_time_t>();
 
-        for (const auto& s : _current_states) {
+        for (const auto& s : *_current_states) {
             latencies += s.get_latency();
             jitter = s.get_jitter_bound();
         }
@@ -321,7 +738,7 @@ namespace monitaal {
         auto in_latencies = boost::icl::interval_set<symb_time_t>(),
             out_latencies = boost::icl::interval_set<symb_time_t>();
 
-        for (const auto& s : _current_states) {
+        for (const auto& s : *_current_states) {
             in_latencies += s.get_input_latency();
             out_latencies += s.get_output_latency();
             in_jitter = s.get_input_jitter();
@@ -27,15 +27,27 @@
 #include "TA.h"
 #include "state.h"
 #include "Fixpoint.h"
+#include "ModelArtifact.h"
+#include "CompiledProperty.h"
 
 #include <boost/icl/interval.hpp>
 #include <boost/icl/interval_set.hpp>
 
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 #include <type_traits>
 
 namespace monitaal {
 
+    struct binary_writer_t;
+    struct binary_reader_t;
+
     enum input_type_e {ONCE, OPTIONAL, MULTI};
     /**
      * A timed character in a timed word.
@@ -50,9 +62,25 @@ namespace monitaal {
         timed_input_t(symb_time_t time, label_t label, input_type_e type = ONCE);
     };
 
+    /**
+     * A timed character that does not own its label, e.g. produced by the MappedEventParser.
+     * label views memory owned by the producer and is only valid until the producer advances.
+     * id is the interned label, see LabelTable.
+     * session is the key of the trace the event belongs to if the events of several traces are interleaved
+     * (see SessionManager), and empty otherwise. It is valid as long as label.
+     */
+    struct event_t {
+        interval_t time{0, 0};
+        label_id_t id = 0;
+        std::string_view label;
+        input_type_e type = ONCE;
+        std::string_view session;
+    };
+
     struct settings_t {
         bool inclusion = false;
         bool clock_abstraction = false;
+        bool time_divergence = false; // Only consider runs where time diverges
         interval_t latency{0,0}, latency_i{0,0};
         symb_time_t jitter = 0, jitter_i = 0;
 
@@ -64,33 +92,92 @@ namespace monitaal {
     enum monitor_answer_e {INCONCLUSIVE, POSITIVE, NEGATIVE};
 
     std::ostream& operator<<(std::ostream& out, const monitor_answer_e value);
+
+    // The input that decided the verdict of a monitor, see Monitor::subscribe
+    struct verdict_change_t {
+        monitor_answer_e verdict;
+        uint64_t event; // Index of the input since the monitor was constructed, reset or restored
+        interval_t time; // Time of the input
+    };
+
+    using verdict_callback_t = std::function<void(const verdict_change_t&)>;
     
     enum single_monitor_answer_e {ACTIVE, OUT};
     // Monitors a single automata one step at a time
     template<class state_t>
     class Single_monitor { // Bad naming I KNOW
-        const TA _automaton;
+    public:
+        // The type of states in the accepting space. Concrete states are checked against symbolic states
+        using space_state_t = std::conditional_t<std::is_base_of<symbolic_state_base, state_t>::value,
+                                                 state_t, symbolic_state_t>;
 
-        // Where it is still possible to reach an accepting location infinitely often
-        const symbolic_state_map_t<typename std::conditional_t<std::is_base_of<symbolic_state_base, state_t>::value, 
-        state_t, symbolic_state_t>> _accepting_space;
+    private:
+        template<class> friend class Monitor;
 
-        std::vector<state_t> _current_states;
+        property_ptr_t<space_state_t> _property;
+
+        // The automaton and accepting space of _property
+        const TA& _automaton;
+        const symbolic_state_map_t<space_state_t>& _accepting_space;
+
+        // The state estimate is shared by forks of the monitor until one of them changes it, see own_states
+        std::shared_ptr<std::vector<state_t>> _current_states;
 
         single_monitor_answer_e _status;
 
+        // The state estimate and status before the first input, restored by reset
+        std::shared_ptr<std::vector<state_t>> _initial_states;
+
+        single_monitor_answer_e _initial_status;
+
+        // The time at which monitoring started. It is subtracted from the time of every input
+        symb_time_t _start = 0;
+
+        void init_states(state_t init);
+
+        // The state estimate for writing. It is copied first if it is shared with another monitor
+        std::vector<state_t>& own_states();
+
+        void write(binary_writer_t& out) const;
+
+        // Reads a side of a checkpoint, see Monitor::checkpoint, without changing the monitor
+        std::tuple<std::vector<state_t>, single_monitor_answer_e, symb_time_t> read(binary_reader_t& in) const;
+
         bool _inclusion,
              _clock_abstraction;
 
     public:
         explicit Single_monitor(const TA &automaton, const settings_t& setting);
 
+        // Monitor with an accepting space that is already computed, e.g. loaded from a model artifact
+        Single_monitor(const TA &automaton, symbolic_state_map_t<space_state_t> accepting_space, const settings_t& setting);
+
+        // Monitor of a compiled property, which is shared and not copied
+        Single_monitor(property_ptr_t<space_state_t> property, const settings_t& setting);
+
+        [[nodiscard]] const property_ptr_t<space_state_t>& property() const;
+
         single_monitor_answer_e status();
 
         single_monitor_answer_e input(const timed_input_t& input);
 
+        single_monitor_answer_e input(const event_t& input);
+
+        /**
+         * Restores the state estimate from before the first input. The accepting space is not recomputed.
+         * @param start: The time of the reset. Inputs are timed as if monitoring began at start,
+         * so their times must not be earlier than start.
+         */
+        void reset(symb_time_t start = 0);
+
         std::vector<state_t> state_estimate();
 
+        /**
+         * The earliest time at which a delay without observations empties the state estimate, or nothing if
+         * the estimate is not emptied by any delay. Not computed for delay and testing states.
+         */
+        [[nodiscard]] std::optional<symb_time_t> deadline() const;
+
         void print_status(std::ostream& out) const;
     };
     /**
@@ -103,20 +190,199 @@ namespace monitaal {
 
         monitor_answer_e _status;
 
+        // If a run of unobserved events can be monitored as one delay, see input_coalesced
+        bool _coalescable;
+
+        uint64_t _events = 0; // Inputs since the monitor was constructed, reset or restored
+
+        uint64_t _next_subscription = 0;
+        std::vector<std::pair<uint64_t, verdict_callback_t>> _subscribers;
+
+        void init_status();
+
+        // Monitors an input without counting it or notifying subscribers
+        monitor_answer_e step(const event_t& input);
+
+        // Monitors a run of unobserved events. Returns the number of events consumed, which is less than the size of
+        // the run if an event in the run decides the verdict
+        size_t input_run(const std::vector<interval_t>& run);
+
     public:
         Monitor(const TA& pos, const TA& neg, const settings_t& setting);
         Monitor(const TA& pos, const TA& neg);
 
+        /**
+         * Monitors a compiled property. The accepting spaces of the artifact are used directly for interval and
+         * concrete monitors. The time divergence setting of the artifact is used instead of the one in setting.
+         */
+        Monitor(const ModelArtifact& artifact, const settings_t& setting);
+
+        /**
+         * Monitors compiled properties, which are shared with other monitors. Creating a monitor only computes the
+         * initial states. The time divergence setting of the properties is used instead of the one in setting.
+         */
+        Monitor(property_ptr_t<typename Single_monitor<state_t>::space_state_t> pos,
+                property_ptr_t<typename Single_monitor<state_t>::space_state_t> neg, const settings_t& setting);
+
         monitor_answer_e input(const std::vector<timed_input_t>& input);
 
+        /**
+         * Monitors the events in [first, last) in order and stops as soon as the verdict is not inconclusive.
+         * The iterator is not advanced past the event that decided the verdict, so lazy parsers stop reading there.
+         */
+        template<class iterator_t>
+        monitor_answer_e input(iterator_t first, iterator_t last) {
+            for (; first != last; ++first) {
+                input(*first);
+                if (_status != INCONCLUSIVE)
+                    break;
+            }
+            return _status;
+        }
+
+        /**
+         * Monitors the events in [first, last) like input(first, last), but a run of consecutive events that neither
+         * automaton observes (see is_observable) is monitored as a single delay to the time of its last event.
+         * The verdict is identical to monitoring every event: if the delay decides the verdict, the run is monitored
+         * again event by event to find the deciding event.
+         *
+         * Events are only coalesced for interval and concrete monitors, if the invariants have no lower bounds on
+         * clocks and if the time bounds of the run are non-decreasing. Otherwise every event is monitored.
+         * @return The number of events consumed, up to and including the event that decided the verdict.
+         */
+        template<class iterator_t>
+        size_t input_coalesced(iterator_t first, iterator_t last) {
+            size_t consumed = 0;
+
+            std::vector<interval_t> run;
+            std::optional<interval_t> previous;
+
+            for (; first != last; ++first) {
+                const auto& event = *first;
+                const interval_t& time = event.time;
+
+                if (_coalescable && previous && not is_observable(event.label) &&
+                    previous->first <= time.first && previous->second <= time.second &&
+                    (not std::is_same_v<state_t, concrete_state_t> || time.first == time.second)) {
+                    run.push_back(time);
+                    previous = time;
+                    continue;
+                }
+
+                consumed += input_run(run);
+                run.clear();
+                if (_status != INCONCLUSIVE)
+                    return consumed;
+
+                input(event);
+                ++consumed;
+                previous = time;
+                if (_status != INCONCLUSIVE)
+                    return consumed;
+            }
+
+            return consumed + input_run(run);
+        }
+
+        /**
+         * True if the label is in the alphabet of the positive or negative automaton.
+         * Other labels (and the empty label) only let time pass.
+         */
+        [[nodiscard]] bool is_observable(std::string_view label) const;
+
+        /**
+         * Restarts monitoring from the initial states, e.g. after a verdict when monitoring a rolling window.
+         * The initial states are shared and the accepting spaces are kept, so this is much cheaper than
+         * constructing a new monitor.
+         */
+        monitor_answer_e reset();
+
+        /**
+         * A copy of the monitor for speculative inputs, e.g. to find the verdict if an event arrived at some time,
+         * without changing this monitor. The fork shares the properties and the state estimates, and copies
+         * the state estimate of a side only when an input changes it. Forks can be monitored in other threads.
+         */
+        [[nodiscard]] Monitor fork() const;
+
+        /**
+         * Like reset, but monitoring restarts at time: the clocks of the automata are zero at time and later inputs
+         * keep their absolute time stamps. Inputs earlier than time are rejected with a base_error.
+         */
+        monitor_answer_e reset_at(symb_time_t time);
+
+        /** CHECKPOINTS
+         *  The verdict and state estimates of the monitor, such that a restarted process can continue monitoring
+         *  without replaying the trace. The accepting spaces are not included, a checkpoint is restored by a monitor
+         *  of the same properties and state type. The layout uses the encoding of BinaryIO.h:
+         *
+         *      Checkpoint := "MTCP" VERSION:u32 TYPE:u8 VERDICT:u8 POSITION:u64 Side(positive) Side(negative)
+         *
+         *      Side := String(automaton name) START:u32 STATUS:u8 u32 State*
+         *      State := LOCATION:u32 DIMENSION:u32 u32 Zone* INPUT_MODE:u8   (symbolic states, see below)
+         *             | LOCATION:u32 u32 u32*                                (concrete states, the valuation)
+         *
+         *  TYPE is 0 for symbolic, 1 for delay, 2 for concrete and 3 for testing states. INPUT_MODE is only
+         *  written for testing states. START is the time of the last reset_at.
+         *
+         * @param position: Stored with the checkpoint and returned by restore, e.g. the number of events monitored.
+         */
+        void checkpoint(std::ostream& out, uint64_t position = 0) const;
+
+        /**
+         * Writes the checkpoint to a temporary file next to path and renames it to path, so path always holds
+         * a complete checkpoint even if the process is killed while writing.
+         */
+        void checkpoint(const std::string& path, uint64_t position = 0) const;
+
+        /**
+         * Replaces the verdict and state estimates by a checkpoint. Throws base_error if the checkpoint is malformed
+         * or was written by a monitor of other automata or another state type.
+         * @return The position stored with the checkpoint.
+         */
+        uint64_t restore(const char* data, size_t size);
+
+        uint64_t restore(const std::string& path);
+
         monitor_answer_e input(const timed_input_t& input);
 
+        monitor_answer_e input(const event_t& input);
+
+        [[nodiscard]] const property_ptr_t<typename Single_monitor<state_t>::space_state_t>& positive_property() const;
+
+        [[nodiscard]] const property_ptr_t<typename Single_monitor<state_t>::space_state_t>& negative_property() const;
+
         std::vector<state_t> positive_state_estimate();
 
         std::vector<state_t> negative_state_estimate();
 
         [[nodiscard]] monitor_answer_e status() const;
 
+        /**
+         * The earliest time at which the verdict is decided if no event is observed until then, i.e. an input at
+         * that time with an unobserved label decides the verdict, and an input at an earlier time does not. A caller
+         * can schedule a timer at the deadline instead of feeding heartbeat events. Nothing if the verdict is not
+         * inconclusive or no delay decides it.
+         *
+         * The deadline is exact if the invariants have no lower bounds on clocks. Otherwise, an earlier delay
+         * may also decide the verdict. Deadlines are only computed for interval and concrete monitors.
+         */
+        [[nodiscard]] std::optional<symb_time_t> deadline() const;
+
+        /**
+         * Calls callback with the input that changes the verdict from inconclusive to positive or negative, so
+         * a caller of many monitors does not check the status of each after every input. Nothing is called if the
+         * verdict is already decided when subscribing, or when reset and restore change the verdict. Subscribers are
+         * called in the order they subscribed, by the thread that inputs, and must not subscribe or unsubscribe.
+         * Forks have no subscribers.
+         * @return An id for unsubscribe.
+         */
+        uint64_t subscribe(verdict_callback_t callback);
+
+        void unsubscribe(uint64_t subscription);
+
+        // The number of inputs since the monitor was constructed, reset or restored (then the restored position)
+        [[nodiscard]] uint64_t events() const;
+
         void print_status(std::ostream& out) const;
 
     };
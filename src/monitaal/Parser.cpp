@@ -22,10 +22,12 @@
 
 #include "Parser.h"
 #include "TA.h"
+#include "errors.h"
 
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <unordered_set>
 #include <boost/algorithm/string/predicate.hpp>
 
 namespace monitaal {
@@ -50,6 +52,56 @@ namespace monitaal {
         return parse(doc, name);
     }
 
+    templates_t Parser::parse_all_data(const char *xml, const std::vector<std::string>& names) {
+        pugi::xml_document doc;
+        auto parse_result = doc.load_string(xml);
+
+        if (not parse_result) {
+            std::cerr << "Parsing string failed: " << parse_result.status;
+            exit(-1);
+        }
+        return parse_all(doc, names);
+    }
+
+    templates_t Parser::parse_all_file(const char *path, const std::vector<std::string>& names) {
+        pugi::xml_document doc;
+        if (not load_file(doc, path)) {
+            std::cerr << "Error: Failed to load model file " << path << '\n';
+            exit(-1);
+        }
+        return parse_all(doc, names);
+    }
+
+    templates_t Parser::parse_all(pugi::xml_document& doc, const std::vector<std::string>& names) {
+        templates_t templates;
+        std::unordered_set<std::string> requested(names.begin(), names.end());
+
+        for (pugi::xml_node xml_ta = doc.child("nta").child("template"); not xml_ta.empty();
+             xml_ta = xml_ta.next_sibling("template")) {
+            std::string name = xml_ta.child("name").text().as_string();
+            if (requested.empty() || requested.contains(name))
+                templates.insert({name, parse_template(xml_ta)});
+        }
+
+        for (const auto& name : names)
+            if (not templates.contains(name))
+                throw base_error("Error: No template named ", name, " in the model");
+
+        return templates;
+    }
+
+    std::map<std::string, property_pair_t> Parser::pair_properties(const templates_t& templates) {
+        std::map<std::string, property_pair_t> properties;
+
+        for (const auto& [name, ta] : templates) {
+            auto negation = templates.find(name == "positive" ? std::string("negative") : "Not" + name);
+            if (negation != templates.end())
+                properties.insert({name, {ta, negation->second}});
+        }
+
+        return properties;
+    }
+
     TA Parser::parse(pugi::xml_document& doc, const char *name) {
         pugi::xml_node xml_ta;
         if (std::strlen(name) == 0)
@@ -58,6 +110,10 @@ namespace monitaal {
             xml_ta = doc.child("nta").find_child([name](pugi::xml_node node) {
                 return not std::strcmp(name, node.child("name").text().as_string()); });
 
+        return parse_template(xml_ta);
+    }
+
+    TA Parser::parse_template(pugi::xml_node xml_ta) {
         pugi::xml_text ta_name = xml_ta.child("name").text();
         std::vector<std::string> ta_clocks;
         ta_clocks.emplace_back("0");
@@ -87,19 +143,21 @@ namespace monitaal {
             location_id_t from = parse_loc_id(tran.child("source").attribute("ref").as_string());
             location_id_t to   = parse_loc_id(tran.child("target").attribute("ref").as_string());
 
-            // Reset
-            auto reset_node = tran.find_child([](pugi::xml_node node){
-                return not std::strcmp(node.attribute("kind").as_string(), "assignment"); });
-            clocks_t reset = parse_reset(reset_node.text().as_string(), ta_clocks);
+            // Reset, guard and synchronisation (as label) in one pass over the labels of the transition
+            pugi::xml_node reset_node, guard_node, sync_node;
+            for (pugi::xml_node node = tran.child("label"); not node.empty(); node = node.next_sibling("label")) {
+                const char* kind = node.attribute("kind").as_string();
+                if (reset_node.empty() && std::strcmp(kind, "assignment") == 0)
+                    reset_node = node;
+                else if (guard_node.empty() && std::strcmp(kind, "guard") == 0)
+                    guard_node = node;
+                else if (sync_node.empty() && std::strcmp(kind, "synchronisation") == 0)
+                    sync_node = node;
+            }
 
-            // Guard
-            auto guard_node = tran.find_child([](pugi::xml_node node){
-                return std::strcmp(node.attribute("kind").as_string(), "guard") == 0; });
+            clocks_t reset = parse_reset(reset_node.text().as_string(), ta_clocks);
             constraints_t guard = parse_constraint(guard_node.text().as_string(), ta_clocks);
 
-            // Synchronisation as label
-            auto sync_node = tran.find_child([](pugi::xml_node node){
-                return std::strcmp(node.attribute("kind").as_string(), "synchronisation") == 0; });
             label_t label = sync_node.text().as_string();
             label = label.substr(0, label.length() - 1); // Remove ! or ?
 
@@ -113,7 +171,10 @@ namespace monitaal {
 
         location_id_t initial = parse_loc_id(xml_ta.child("init").attribute("ref").as_string());
 
-        return TA(ta_name.as_string(), clocks, locations, edges, initial);
+        TA automaton(ta_name.as_string(), clocks, locations, edges, initial);
+        automaton.trim();
+
+        return automaton;
     }
 
     bool Parser::load_file(pugi::xml_document &doc, const char *path) {
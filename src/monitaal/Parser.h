@@ -28,19 +28,47 @@
 
 #include <pugixml.hpp>
 
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace monitaal {
 
     enum operator_e {
         ASSIGN, EQ, G, GE, L, LE
     };
 
+    using templates_t = std::map<std::string, TA>;
+
+    // A property automaton and the automaton of its negation
+    using property_pair_t = std::pair<TA, TA>;
+
     class Parser {
     public:
         static TA parse_data(const char *xml, const char *name);
         static TA parse_file(const char *path, const char *name);
         static TA parse(pugi::xml_document& doc, const char *name);
 
+        /**
+         * Parses the document once and returns the requested templates indexed by name.
+         * @param names: Names of the templates to parse. All templates are parsed if empty.
+         * Throws base_error if a requested template is not in the document.
+         */
+        static templates_t parse_all_data(const char *xml, const std::vector<std::string>& names = {});
+        static templates_t parse_all_file(const char *path, const std::vector<std::string>& names = {});
+        static templates_t parse_all(pugi::xml_document& doc, const std::vector<std::string>& names = {});
+
+        /**
+         * Pairs each property template with the template of its negation, indexed by the name of the property.
+         * The template "positive" is paired with "negative", and any other template X with "NotX".
+         * Templates without a partner are left out.
+         */
+        static std::map<std::string, property_pair_t> pair_properties(const templates_t& templates);
+
     private:
+        static TA parse_template(pugi::xml_node xml_ta);
+
         static bool load_file(pugi::xml_document& doc, const char *path);
 
         static constraints_t parse_constraint(const std::string& input, std::vector<std::string>& clocks);
@@ -0,0 +1,94 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PerfectHash.h"
+#include "errors.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace monitaal {
+
+    PerfectHash::PerfectHash(std::vector<std::string> keys) {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        if (keys.empty())
+            return;
+
+        auto [shortest, longest] = std::minmax_element(keys.begin(), keys.end(),
+                [](const std::string& a, const std::string& b) { return a.size() < b.size(); });
+        _min_length = shortest->size();
+        _max_length = longest->size();
+
+        const size_t n = keys.size();
+        _displacements.assign(std::max<size_t>(1, (n + 1) / 2), 0);
+
+        std::vector<uint64_t> hashes(n);
+        std::vector<std::vector<size_t>> buckets(_displacements.size());
+        for (size_t k = 0; k < n; ++k) {
+            hashes[k] = hash(keys[k]);
+            buckets[bucket(hashes[k])].push_back(k);
+        }
+
+        // Place the largest buckets first, while there are many free slots
+        std::vector<size_t> order(buckets.size());
+        for (size_t b = 0; b < order.size(); ++b)
+            order[b] = b;
+        std::stable_sort(order.begin(), order.end(),
+                         [&buckets](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        std::vector<bool> taken(n, false);
+        std::vector<size_t> slots;
+        _keys.assign(n, std::string());
+
+        for (auto b : order) {
+            if (buckets[b].empty())
+                break;
+
+            for (uint32_t d = 0;; ++d) {
+                if (d == std::numeric_limits<uint32_t>::max())
+                    throw base_error("Error: Could not build a perfect hash over ", n, " keys");
+
+                slots.clear();
+                bool fits = true;
+                for (auto k : buckets[b]) {
+                    auto s = slot_hash(hashes[k], d) % n;
+                    if (taken[s] || std::find(slots.begin(), slots.end(), s) != slots.end()) {
+                        fits = false;
+                        break;
+                    }
+                    slots.push_back(s);
+                }
+
+                if (fits) {
+                    _displacements[b] = d;
+                    for (size_t i = 0; i < slots.size(); ++i) {
+                        taken[slots[i]] = true;
+                        _keys[slots[i]] = std::move(keys[buckets[b][i]]);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MONITAAL_PERFECT_HASH_H
+#define MONITAAL_PERFECT_HASH_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace monitaal {
+
+    /**
+     * Minimal perfect hash over a fixed set of strings (hash and displace).
+     *
+     * A key is hashed once. The hash selects a bucket, and the displacement of the bucket selects the slot of the key,
+     * such that the n keys occupy exactly n slots. A lookup therefore hashes the key and compares it with a single
+     * stored key: unknown strings are rejected without probing. The index of a key is its slot, i.e. in [0, size()).
+     */
+    class PerfectHash {
+        std::vector<std::string> _keys;         // By slot
+        std::vector<uint32_t> _displacements;   // By bucket
+
+        size_t _min_length = 0, _max_length = 0;
+
+        static uint64_t hash(std::string_view key);
+
+        static uint64_t slot_hash(uint64_t hash, uint32_t displacement);
+
+        [[nodiscard]] size_t bucket(uint64_t hash) const;
+
+        [[nodiscard]] size_t slot(uint64_t hash) const;
+
+    public:
+        PerfectHash() = default;
+
+        /**
+         * Duplicate keys are stored once.
+         */
+        template<class iterator_t>
+        PerfectHash(iterator_t first, iterator_t last) : PerfectHash(std::vector<std::string>(first, last)) {}
+
+        explicit PerfectHash(std::vector<std::string> keys);
+
+        /**
+         * The index of key, or nothing if key is not in the set.
+         */
+        [[nodiscard]] std::optional<uint32_t> find(std::string_view key) const {
+            if (key.size() < _min_length || key.size() > _max_length || _keys.empty())
+                return std::nullopt;
+
+            auto index = slot(hash(key));
+            if (_keys[index] != key)
+                return std::nullopt;
+            return static_cast<uint32_t>(index);
+        }
+
+        [[nodiscard]] bool contains(std::string_view key) const { return find(key).has_value(); }
+
+        [[nodiscard]] const std::string& key(uint32_t index) const { return _keys[index]; }
+
+        [[nodiscard]] size_t size() const { return _keys.size(); }
+    };
+
+    inline uint64_t PerfectHash::hash(std::string_view key) {
+        // FNV-1a
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : key) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    inline uint64_t PerfectHash::slot_hash(uint64_t hash, uint32_t displacement) {
+        // Final mix of splitmix64
+        uint64_t h = hash + (static_cast<uint64_t>(displacement) + 1) * 0x9e3779b97f4a7c15ull;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        return h ^ (h >> 31);
+    }
+
+    inline size_t PerfectHash::bucket(uint64_t hash) const { return (hash >> 32) % _displacements.size(); }
+
+    inline size_t PerfectHash::slot(uint64_t hash) const {
+        return slot_hash(hash, _displacements[bucket(hash)]) % _keys.size();
+    }
+}
+
+#endif //MONITAAL_PERFECT_HASH_H
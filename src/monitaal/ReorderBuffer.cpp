@@ -0,0 +1,140 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "ReorderBuffer.h"
+#include "errors.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace monitaal {
+
+    namespace {
+        // The heap is a max-heap, so the entry that comes last is the greatest
+        struct later_t {
+            bool operator()(const auto& a, const auto& b) const {
+                if (a.event.time.first != b.event.time.first)
+                    return a.event.time.first > b.event.time.first;
+                if (a.event.time.second != b.event.time.second)
+                    return a.event.time.second > b.event.time.second;
+                return a.arrival > b.arrival;
+            }
+        };
+    }
+
+    ReorderBuffer::ReorderBuffer(std::shared_ptr<void> owner, std::function<bool(event_t&)> next,
+                                 reorder_window_t window) :
+            _owner(std::move(owner)), _next(std::move(next)), _window(window) {
+        if (not _window.time && _window.count == 0)
+            throw base_error("Error: A reorder window needs a time or a number of events");
+        if (_window.count > 0)
+            _heap.reserve(_window.count);
+    }
+
+    void ReorderBuffer::set_late_handler(std::function<void(const event_t&)> handler) {
+        _late_handler = std::move(handler);
+    }
+
+    void ReorderBuffer::pull() {
+        entry_t entry{{}, _arrivals};
+        if (not _next(entry.event)) {
+            _exhausted = true;
+            return;
+        }
+        ++_arrivals;
+
+        // The event belongs before an event that has already been released
+        if (_released && entry.event.time.first < _event.time.first) {
+            ++_late;
+            if (not _late_handler)
+                throw base_error("Error: Event ", _arrivals, " is at ", entry.event.time.first,
+                                 " which is before the released event at ", _event.time.first,
+                                 ". It arrived later than the reorder window");
+            _late_handler(entry.event);
+            return;
+        }
+
+        // The source may reuse the memory of labels and sessions once it advances
+        constexpr auto unmapped = std::numeric_limits<label_id_t>::max();
+        if (entry.event.id >= _ids.size())
+            _ids.resize(entry.event.id + 1, unmapped);
+        auto& id = _ids[entry.event.id];
+        if (id == unmapped)
+            id = _labels.intern(entry.event.label);
+        entry.event.id = id;
+        entry.event.label = _labels.label(id);
+        if (not entry.event.session.empty())
+            entry.event.session = _sessions.label(_sessions.intern(entry.event.session));
+
+        _latest = std::max(_latest, entry.event.time.first);
+
+        _heap.push_back(entry);
+        std::push_heap(_heap.begin(), _heap.end(), later_t());
+    }
+
+    bool ReorderBuffer::is_due() const {
+        if (_heap.empty())
+            return false;
+        if (_exhausted || (_window.count > 0 && _heap.size() >= _window.count))
+            return true;
+        return _window.time && _latest - _heap.front().event.time.first >= *_window.time;
+    }
+
+    bool ReorderBuffer::next() {
+        while (not _exhausted && not is_due())
+            pull();
+
+        if (_heap.empty())
+            return false;
+
+        std::pop_heap(_heap.begin(), _heap.end(), later_t());
+        _event = _heap.back().event;
+        _heap.pop_back();
+        _released = true;
+        return true;
+    }
+
+    ReorderBuffer::iterator::iterator(ReorderBuffer* buffer) : _buffer(buffer) {
+        if (not _buffer->next())
+            _buffer = nullptr;
+    }
+
+    ReorderBuffer::iterator& ReorderBuffer::iterator::operator++() {
+        if (not _buffer->next())
+            _buffer = nullptr;
+        return *this;
+    }
+
+    ReorderBuffer::iterator ReorderBuffer::begin() {
+        if (_started)
+            throw base_error("Error: A ReorderBuffer can only be read once");
+        _started = true;
+        return iterator(this);
+    }
+
+    ReorderBuffer::iterator ReorderBuffer::end() { return {}; }
+
+    size_t ReorderBuffer::late_events() const { return _late; }
+
+    const LabelTable& ReorderBuffer::labels() const { return _labels; }
+}
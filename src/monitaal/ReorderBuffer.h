@@ -0,0 +1,144 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_REORDER_BUFFER_H
+#define MONITAAL_REORDER_BUFFER_H
+
+#include "Monitor.h"
+#include "EventMerger.h"
+#include "LabelTable.h"
+#include "types.h"
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace monitaal {
+
+    /**
+     * How long an event is held back to wait for earlier events. An event is released once an event that is at least
+     * time later has arrived, or once count events are held. At least one of them must be given.
+     */
+    struct reorder_window_t {
+        std::optional<symb_time_t> time;
+        size_t count = 0; // 0 for no bound on the number of held events
+    };
+
+    /**
+     * Sorts a source of events that is only slightly out of order, e.g. events delivered by several distributed
+     * producers, into a timed word ordered by time. Events are held in a heap bounded by the window, so sorting
+     * costs O(log n) per event for n held events.
+     *
+     * Events are ordered like in EventMerger, and events at equal times keep their order of arrival.
+     * An event that arrives after a later event has been released is late. Late events are passed to the late handler
+     * and dropped, or a base_error is thrown if there is no handler.
+     * Ids of the released events are interned in labels(), and labels and sessions are owned by the buffer, so they
+     * stay valid while the buffer lives.
+     */
+    class ReorderBuffer {
+        struct entry_t {
+            event_t event;
+            size_t arrival;
+        };
+
+        std::shared_ptr<void> _owner;           // Keeps an owned source alive
+        std::function<bool(event_t&)> _next;    // Reads the next event of the source
+        reorder_window_t _window;
+        std::function<void(const event_t&)> _late_handler;
+
+        std::vector<entry_t> _heap;
+        std::vector<label_id_t> _ids;           // Interned id by id in the source
+        LabelTable _labels, _sessions;
+
+        size_t _arrivals = 0, _late = 0;
+        symb_time_t _latest = 0;                // The latest lower bound that has arrived
+        bool _started = false, _exhausted = false, _released = false;
+
+        event_t _event;
+
+        ReorderBuffer(std::shared_ptr<void> owner, std::function<bool(event_t&)> next, reorder_window_t window);
+
+        // Reads the next event of the source into the heap, unless it is late
+        void pull();
+
+        // True if the earliest held event can be released
+        [[nodiscard]] bool is_due() const;
+
+        // Moves the next event into _event. Returns false if there are no more events
+        bool next();
+
+    public:
+        class iterator {
+            friend class ReorderBuffer;
+
+            ReorderBuffer* _buffer = nullptr; // nullptr when there are no more events
+
+            explicit iterator(ReorderBuffer* buffer);
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _buffer->_event; }
+            pointer operator->() const { return &_buffer->_event; }
+
+            iterator& operator++();
+            void operator++(int) { ++*this; }
+
+            bool operator==(const iterator& other) const { return _buffer == other._buffer; }
+        };
+
+        // Sorts a range of events, e.g. a StreamEventParser, which must outlive the buffer
+        template<class range_t>
+        ReorderBuffer(range_t& events, reorder_window_t window) :
+                ReorderBuffer(nullptr, event_reader(events), window) {}
+
+        // Sorts a range of events that is owned by the buffer
+        template<class range_t>
+        ReorderBuffer(std::shared_ptr<range_t> events, reorder_window_t window) :
+                ReorderBuffer(events, event_reader(*events), window) {}
+
+        ReorderBuffer(const ReorderBuffer&) = delete;
+        ReorderBuffer& operator=(const ReorderBuffer&) = delete;
+
+        // Late events are passed to handler instead of throwing. The event is only valid during the call
+        void set_late_handler(std::function<void(const event_t&)> handler);
+
+        // Starts reading the source. Can only be called once
+        iterator begin();
+        iterator end();
+
+        [[nodiscard]] size_t late_events() const;
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+}
+
+#endif //MONITAAL_REORDER_BUFFER_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MONITAAL_SPSC_RING_H
+#define MONITAAL_SPSC_RING_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace monitaal {
+
+    /**
+     * Lock-free bounded queue for exactly one producer thread and one consumer thread.
+     *
+     * The blocking push and pop spin briefly and then yield while the ring is full or empty, which gives backpressure
+     * to the faster side. Either side may close the ring: the consumer to stop the producer early (push then returns
+     * false), the producer to signal the end (pop returns false once the ring is drained).
+     */
+    template<class T>
+    class SPSCRing {
+        static constexpr size_t cache_line = 64;
+
+        std::vector<T> _buffer;
+        const size_t _mask;
+
+        // Written by the consumer
+        alignas(cache_line) std::atomic<size_t> _head{0};
+        size_t _cached_tail = 0;
+
+        // Written by the producer
+        alignas(cache_line) std::atomic<size_t> _tail{0};
+        size_t _cached_head = 0;
+
+        alignas(cache_line) std::atomic<bool> _closed{false};
+
+        // Spinning only pays off if the other side runs on another core
+        static void backoff(unsigned& spins) {
+            static const unsigned spin_limit = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+            if (++spins > spin_limit)
+                std::this_thread::yield();
+        }
+
+    public:
+        /**
+         * The capacity is rounded up to a power of two.
+         */
+        explicit SPSCRing(size_t capacity) :
+                _buffer(std::bit_ceil(capacity < 2 ? size_t(2) : capacity)), _mask(_buffer.size() - 1) {}
+
+        SPSCRing(const SPSCRing&) = delete;
+        SPSCRing& operator=(const SPSCRing&) = delete;
+
+        [[nodiscard]] size_t capacity() const { return _buffer.size(); }
+
+        // Producer only
+        bool try_push(const T& value) {
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _cached_head == _buffer.size()) {
+                _cached_head = _head.load(std::memory_order_acquire);
+                if (tail - _cached_head == _buffer.size())
+                    return false;
+            }
+            _buffer[tail & _mask] = value;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only
+        bool try_pop(T& value) {
+            auto head = _head.load(std::memory_order_relaxed);
+            if (head == _cached_tail) {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+                if (head == _cached_tail)
+                    return false;
+            }
+            value = _buffer[head & _mask];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Producer only. Waits while the ring is full. Returns false (without pushing) if the ring is closed.
+         */
+        bool push(const T& value) {
+            unsigned spins = 0;
+            while (not closed()) {
+                if (try_push(value))
+                    return true;
+                backoff(spins);
+            }
+            return false;
+        }
+
+        /**
+         * Consumer only. Waits while the ring is empty. Returns false if the ring is closed and empty.
+         */
+        bool pop(T& value) {
+            unsigned spins = 0;
+            while (true) {
+                if (try_pop(value))
+                    return true;
+                if (closed()) // Values pushed before closing are still delivered
+                    return try_pop(value);
+                backoff(spins);
+            }
+        }
+
+        void close() { _closed.store(true, std::memory_order_release); }
+
+        [[nodiscard]] bool closed() const { return _closed.load(std::memory_order_acquire); }
+    };
+}
+
+#endif //MONITAAL_SPSC_RING_H
@@ -0,0 +1,241 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "SessionManager.h"
+#include "errors.h"
+
+#include <utility>
+
+namespace monitaal {
+
+    std::ostream& operator<<(std::ostream& out, session_end_e value) {
+        switch (value) {
+            case VERDICT: out << "VERDICT"; break;
+            case DEADLINE: out << "DEADLINE"; break;
+            case IDLE: out << "IDLE"; break;
+            case END: out << "END"; break;
+        }
+        return out;
+    }
+
+    template<class state_t>
+    SessionManager<state_t>::SessionManager(property_ptr_t<space_state_t> positive,
+                                            property_ptr_t<space_state_t> negative,
+                                            const settings_t& monitor_settings, const session_settings_t& settings,
+                                            callback_t callback) :
+            _positive(std::move(positive)), _negative(std::move(negative)), _monitor_settings(monitor_settings),
+            _settings(settings), _callback(std::move(callback)), _shards(std::max<size_t>(settings.shards, 1)) {
+
+        if (_settings.shards == 0)
+            return;
+
+        for (auto& shard : _shards) {
+            shard.queue = std::make_unique<SPSCRing<item_t>>(_settings.queue_capacity);
+            shard.worker = std::thread([this, &shard]() {
+                item_t item;
+                try {
+                    while (shard.queue->pop(item))
+                        process(shard, item.event, item.session);
+                } catch (...) {
+                    shard.error = std::current_exception();
+                    shard.queue->close(); // Events of the shard are dropped from now on
+                }
+            });
+        }
+    }
+
+    template<class state_t>
+    SessionManager<state_t>::~SessionManager() {
+        // Errors are only reported by an explicit finish()
+        try {
+            finish();
+        } catch (...) {}
+    }
+
+    template<class state_t>
+    typename SessionManager<state_t>::shard_t& SessionManager<state_t>::shard_of(std::string_view session) {
+        return _shards[_shards.size() == 1 ? 0 : label_hash_t()(session) % _shards.size()];
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::input(const event_t& event) {
+        if (_finished)
+            throw base_error("Error: Events cannot be input to a finished SessionManager");
+
+        auto& shard = shard_of(event.session);
+        if (shard.queue) {
+            item_t item{event, std::string(event.session)};
+            item.event.session = std::string_view();
+            shard.queue->push(item);
+        } else
+            process(shard, event, event.session);
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::process(shard_t& shard, const event_t& event, std::string_view key) {
+        if (_settings.deadlines) {
+            if (event.time.first < shard.now)
+                throw base_error("Error: Event at ", event.time.first, " is before the previous event at ", shard.now,
+                                 ". Deadlines require the events to be ordered by time");
+            // The deadline of the session of the event may have passed before the event
+            if (event.time.first > 0)
+                fire_deadlines(shard, event.time.first - 1);
+        }
+
+        ++shard.events;
+        shard.now = std::max(shard.now, event.time.first);
+
+        auto session = shard.sessions.find(key);
+        if (session == shard.sessions.end()) {
+            session = shard.sessions.try_emplace(std::string(key),
+                    session_t{Monitor<state_t>(_positive, _negative, _monitor_settings), event.time.first, {}}).first;
+            session->second.activity = shard.by_activity.insert(shard.by_activity.end(), session->first);
+            session->second.monitor.reset_at(event.time.first);
+        } else
+            shard.by_activity.splice(shard.by_activity.end(), shard.by_activity, session->second.activity);
+
+        auto& monitor = session->second.monitor;
+        session->second.last_time = event.time.first;
+        if (monitor.input(event) != INCONCLUSIVE) {
+            ++shard.finished;
+            evict(shard, session, VERDICT);
+        } else if (_settings.deadlines) {
+            schedule_deadline(shard, session);
+            fire_deadlines(shard, shard.now);
+        }
+
+        evict_idle(shard);
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::schedule_deadline(shard_t& shard, typename sessions_t::iterator session) {
+        auto& deadline = session->second.deadline;
+        if (deadline)
+            shard.deadlines.cancel(*deadline);
+        deadline.reset();
+
+        if (auto time = session->second.monitor.deadline())
+            deadline = shard.deadlines.schedule(*time, session->first);
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::fire_deadlines(shard_t& shard, symb_time_t time) {
+        shard.deadlines.advance(time, [this, &shard](symb_time_t deadline, std::string_view key) {
+            auto session = shard.sessions.find(key);
+            session->second.deadline.reset();
+
+            // Silence until the deadline, i.e. an input that no automaton observes
+            if (session->second.monitor.input(event_t{{deadline, deadline}}) != INCONCLUSIVE) {
+                ++shard.finished;
+                evict(shard, session, DEADLINE);
+            } else if (auto next = session->second.monitor.deadline(); next && *next > deadline)
+                // The deadline is not exact if invariants have lower bounds
+                session->second.deadline = shard.deadlines.schedule(*next, session->first);
+        });
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::evict_idle(shard_t& shard) {
+        if (not _settings.idle_timeout)
+            return;
+
+        while (not shard.by_activity.empty()) {
+            auto session = shard.sessions.find(shard.by_activity.front());
+            if (session->second.last_time + *_settings.idle_timeout >= shard.now)
+                break;
+            evict(shard, session, IDLE);
+        }
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::evict(shard_t& shard, typename sessions_t::iterator session, session_end_e reason) {
+        report(session->first, reason, session->second.monitor);
+        if (session->second.deadline)
+            shard.deadlines.cancel(*session->second.deadline);
+        shard.by_activity.erase(session->second.activity);
+        shard.sessions.erase(session);
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::report(std::string_view session, session_end_e reason,
+                                         const Monitor<state_t>& monitor) {
+        if (not _callback)
+            return;
+        std::lock_guard lock(_callback_mutex);
+        _callback(session, monitor.status(), reason, monitor);
+    }
+
+    template<class state_t>
+    void SessionManager<state_t>::finish() {
+        if (_finished)
+            return;
+        _finished = true;
+
+        for (auto& shard : _shards)
+            if (shard.queue)
+                shard.queue->close();
+        for (auto& shard : _shards)
+            if (shard.worker.joinable())
+                shard.worker.join();
+        for (auto& shard : _shards)
+            if (shard.error)
+                std::rethrow_exception(shard.error);
+
+        // No event comes after the latest event of all shards, so the sessions are silent until then
+        if (_settings.deadlines) {
+            symb_time_t now = 0;
+            for (const auto& shard : _shards)
+                now = std::max(now, shard.now);
+            for (auto& shard : _shards)
+                fire_deadlines(shard, now);
+        }
+
+        for (auto& shard : _shards)
+            while (not shard.by_activity.empty())
+                evict(shard, shard.sessions.find(shard.by_activity.front()), END);
+    }
+
+    template<class state_t>
+    size_t SessionManager<state_t>::active_sessions() const {
+        size_t sessions = 0;
+        for (const auto& shard : _shards)
+            sessions += shard.sessions.size();
+        return sessions;
+    }
+
+    template<class state_t>
+    size_t SessionManager<state_t>::finished_sessions() const {
+        size_t finished = 0;
+        for (const auto& shard : _shards)
+            finished += shard.finished;
+        return finished;
+    }
+
+    template<class state_t>
+    size_t SessionManager<state_t>::number_of_shards() const { return _settings.shards; }
+
+    template class SessionManager<symbolic_state_t>;
+    template class SessionManager<concrete_state_t>;
+    template class SessionManager<delay_state_t>;
+    template class SessionManager<testing_state_t>;
+}
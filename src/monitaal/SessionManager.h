@@ -0,0 +1,183 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_SESSION_MANAGER_H
+#define MONITAAL_SESSION_MANAGER_H
+
+#include "Monitor.h"
+#include "CompiledProperty.h"
+#include "SPSCRing.h"
+#include "TimerWheel.h"
+#include "types.h"
+
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace monitaal {
+
+    enum session_end_e {
+        VERDICT, // The verdict of the session is final
+        DEADLINE, // The verdict of the session was decided by silence at its deadline
+        IDLE,    // The session had no events for longer than the idle timeout
+        END      // The manager is finished while the session is inconclusive
+    };
+
+    std::ostream& operator<<(std::ostream& out, session_end_e value);
+
+    struct session_settings_t {
+        // Worker threads, each owning the sessions of one shard. 0 monitors the sessions in the calling thread
+        size_t shards = 0;
+
+        // A session is evicted if the latest event of its shard is more than this after its last event
+        std::optional<symb_time_t> idle_timeout;
+
+        // Events queued per shard before the caller waits
+        size_t queue_capacity = 4096;
+
+        /**
+         * Decide the verdict of a silent session at its deadline (see Monitor::deadline), once its shard has an event
+         * after the deadline or the manager is finished. Requires the events of each shard to be ordered by time.
+         */
+        bool deadlines = false;
+    };
+
+    /**
+     * Monitors the same property for many independent traces whose events are interleaved in one stream, e.g. one
+     * trace per vehicle. Events are routed by event_t::session, and a monitor over the shared compiled properties is
+     * created on the first event of a session. Monitoring of a session starts at the time of its first event, so the
+     * clocks of the automata are zero at that time (see Monitor::reset_at).
+     *
+     * A session is evicted once its verdict is final, or if it is idle, and the callback is told why. A later event of
+     * an evicted session starts a new session with the same key. Sessions are sharded by a hash of their key, and each
+     * shard is owned by one worker thread, so a session is always monitored by the same thread and in order.
+     *
+     * The callback is never called concurrently, but it is called from the worker threads if there are shards.
+     * Labels of queued events must stay valid until finish(), which holds for labels from the parsers of MoniTAal.
+     */
+    template<class state_t>
+    class SessionManager {
+    public:
+        using space_state_t = typename Single_monitor<state_t>::space_state_t;
+        using callback_t = std::function<void(std::string_view session, monitor_answer_e verdict, session_end_e reason,
+                                              const Monitor<state_t>& monitor)>;
+
+    private:
+        struct session_t {
+            Monitor<state_t> monitor;
+            symb_time_t last_time = 0;
+            std::list<std::string_view>::iterator activity; // In shard_t::by_activity
+            std::optional<typename TimerWheel<std::string_view>::timer_id_t> deadline; // In shard_t::deadlines
+        };
+
+        using sessions_t = std::unordered_map<std::string, session_t, label_hash_t, std::equal_to<>>;
+
+        struct item_t {
+            event_t event;
+            std::string session; // Owned, since the event only views the session of the producer
+        };
+
+        struct shard_t {
+            sessions_t sessions;
+            std::list<std::string_view> by_activity; // Keys of the sessions, least recently active first
+            TimerWheel<std::string_view> deadlines; // Keys of the sessions by the deadlines of their monitors
+            symb_time_t now = 0;
+            size_t events = 0, finished = 0;
+
+            std::unique_ptr<SPSCRing<item_t>> queue;
+            std::thread worker;
+            std::exception_ptr error; // Thrown by the worker, rethrown by finish()
+        };
+
+        property_ptr_t<space_state_t> _positive, _negative;
+        settings_t _monitor_settings;
+        session_settings_t _settings;
+
+        callback_t _callback;
+        std::mutex _callback_mutex;
+
+        std::vector<shard_t> _shards;
+        bool _finished = false;
+
+        shard_t& shard_of(std::string_view session);
+
+        void process(shard_t& shard, const event_t& event, std::string_view session);
+
+        void evict(shard_t& shard, typename sessions_t::iterator session, session_end_e reason);
+
+        void evict_idle(shard_t& shard);
+
+        // Schedules the deadline of a session whose verdict is inconclusive
+        void schedule_deadline(shard_t& shard, typename sessions_t::iterator session);
+
+        // Decides the verdicts of the sessions with deadlines at or before time
+        void fire_deadlines(shard_t& shard, symb_time_t time);
+
+        void report(std::string_view session, session_end_e reason, const Monitor<state_t>& monitor);
+
+    public:
+        SessionManager(property_ptr_t<space_state_t> positive, property_ptr_t<space_state_t> negative,
+                       const settings_t& monitor_settings, const session_settings_t& settings, callback_t callback = {});
+
+        // Finishes the sessions if finish() is not called
+        ~SessionManager();
+
+        SessionManager(const SessionManager&) = delete;
+        SessionManager& operator=(const SessionManager&) = delete;
+
+        /**
+         * Routes an event to its session. Must be called from one thread, with the events of each session in order.
+         */
+        void input(const event_t& event);
+
+        template<class iterator_t>
+        void input(iterator_t first, iterator_t last) {
+            for (; first != last; ++first)
+                input(*first);
+        }
+
+        /**
+         * Waits for the shards to monitor all queued events and ends the remaining sessions (with reason END).
+         * No events can be input after. Rethrows an error of a worker, e.g. from the callback.
+         */
+        void finish();
+
+        // The number of sessions that are not evicted. Only exact without shards or after finish()
+        [[nodiscard]] size_t active_sessions() const;
+
+        // The number of sessions with a final verdict. Only exact without shards or after finish()
+        [[nodiscard]] size_t finished_sessions() const;
+
+        [[nodiscard]] size_t number_of_shards() const;
+    };
+}
+
+#endif //MONITAAL_SESSION_MANAGER_H
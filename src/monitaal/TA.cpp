@@ -22,17 +22,23 @@
 
 #include "types.h"
 #include "TA.h"
+#include "errors.h"
 
 #include <utility>
 #include <iostream>
+#include <algorithm>
 #include <boost/dynamic_bitset.hpp>
 
 namespace monitaal {
 
-    location_t::location_t(bool accept, location_id_t id, std::string name, constraints_t invariant) :
+    location_t::location_t(accept_sets_t accept, location_id_t id, std::string name, constraints_t invariant) :
             _accept(accept), _id(id), _name(std::move(name)), _invariant(std::move(invariant)) {}
 
-    bool location_t::is_accept() const { return _accept; }
+    bool location_t::is_accept() const { return _accept != 0; }
+
+    bool location_t::is_accept(uint32_t set) const { return (_accept >> set) & 1; }
+
+    accept_sets_t location_t::accept_sets() const { return _accept; }
 
     location_id_t location_t::id() const { return _id; }
 
@@ -77,38 +83,132 @@ namespace monitaal {
         return rtn;
     }
 
-    label_t edge_t::label() const {return _label;}
+    const label_t& edge_t::label() const {return _label;}
+
+    TA::TA(std::string name, clock_map_t clocks, const locations_t &locations, const edges_t &edges, location_id_t initial,
+           uint32_t number_of_accept_sets) :
+            _name(std::move(name)), _clock_names(clocks), _initial(initial), _number_of_clocks(clocks.size()),
+            _number_of_accept_sets(number_of_accept_sets) {
+        if (_number_of_accept_sets == 0 || _number_of_accept_sets > 8 * sizeof(accept_sets_t))
+            throw base_error("Error: Number of acceptance sets must be between 1 and ", 8 * sizeof(accept_sets_t),
+                             " but was ", _number_of_accept_sets);
+
+        build_edge_maps(locations, edges);
+        build_label_index();
+
+        _inactive_clocks = compute_inactive_clocks();
+    }
+
+    TA::TA(std::string name, clock_map_t clocks, const locations_t &locations, const edges_t &edges, location_id_t initial,
+           uint32_t number_of_accept_sets, const label_set_t &labels,
+           std::map<location_id_t, std::vector<clock_index_t>> inactive_clocks) :
+            _name(std::move(name)), _clock_names(clocks), _inactive_clocks(std::move(inactive_clocks)),
+            _initial(initial), _number_of_clocks(clocks.size()), _number_of_accept_sets(number_of_accept_sets) {
+        if (_number_of_accept_sets == 0 || _number_of_accept_sets > 8 * sizeof(accept_sets_t))
+            throw base_error("Error: Number of acceptance sets must be between 1 and ", 8 * sizeof(accept_sets_t),
+                             " but was ", _number_of_accept_sets);
+
+        build_edge_maps(locations, edges);
+        _labels.insert(labels.begin(), labels.end());
+        build_label_index();
+    }
+
+    void TA::build_label_index() { _label_index = PerfectHash(_labels.begin(), _labels.end()); }
 
-    TA::TA(std::string name, clock_map_t clocks, const locations_t &locations, const edges_t &edges, location_id_t initial) :
-            _name(std::move(name)), _number_of_clocks(clocks.size()), _clock_names(clocks), _initial(initial) {
+    void TA::build_edge_maps(const locations_t &locations, const edges_t &edges) {
         location_map_t loc_map;
         edge_map_t backward_edges, forward_edges;
 
         for (const auto &l : locations) {
             loc_map.insert({l.id(), l});
+            backward_edges.insert({l.id(), edges_t()});
+            forward_edges.insert({l.id(), edges_t()});
+        }
 
-            edges_t to, from;
-            for (const auto &e : edges) {
-                _labels.insert(e.label());
-                if (e.to() == l.id())
-                    to.push_back(e);
-                if (e.from() == l.id())
-                    from.push_back(e);
-            }
-            backward_edges.insert({l.id(), to});
-            forward_edges.insert({l.id(), from});
-
+        for (const auto &e : edges) {
+            _labels.insert(e.label());
+            backward_edges.at(e.to()).push_back(e);
+            forward_edges.at(e.from()).push_back(e);
         }
 
         _locations = std::move(loc_map);
         _backward_edges = std::move(backward_edges);
         _forward_edges = std::move(forward_edges);
-        
-        _inactive_clocks = compute_inactive_clocks();
     }
 
 
 
+    void TA::trim() {
+        std::map<location_id_t, location_id_t> reachable;
+        std::vector<location_id_t> waiting;
+
+        // Forward from the initial location. The order of discovery is also the new (dense) numbering
+        reachable.insert({_initial, 0});
+        std::vector<location_id_t> order{_initial};
+        waiting.push_back(_initial);
+        while (not waiting.empty()) {
+            auto l = waiting.back();
+            waiting.pop_back();
+            for (const auto& e : edges_from(l))
+                if (reachable.insert({e.to(), order.size()}).second) {
+                    order.push_back(e.to());
+                    waiting.push_back(e.to());
+                }
+        }
+
+        // Backward from each acceptance set. A location is live if it can reach all of them
+        std::map<location_id_t, uint32_t> coreachable;
+        std::unordered_set<location_id_t> passed;
+        for (uint32_t set = 0; set < _number_of_accept_sets; ++set) {
+            passed.clear();
+            for (const auto& [id, loc] : _locations)
+                if (loc.is_accept(set)) {
+                    passed.insert(id);
+                    waiting.push_back(id);
+                }
+            while (not waiting.empty()) {
+                auto l = waiting.back();
+                waiting.pop_back();
+                for (const auto& e : edges_to(l))
+                    if (passed.insert(e.from()).second)
+                        waiting.push_back(e.from());
+            }
+            for (const auto& l : passed)
+                ++coreachable[l];
+        }
+
+        // The initial location is always kept, such that the automaton stays well-formed
+        std::map<location_id_t, location_id_t> rename;
+        for (const auto& l : order)
+            if (l == _initial || (coreachable.contains(l) && coreachable.at(l) == _number_of_accept_sets))
+                rename.insert({l, rename.size()});
+
+        if (rename.size() == _locations.size() && std::all_of(rename.begin(), rename.end(),
+                [](const auto& r) { return r.first == r.second; }))
+            return;
+
+        locations_t new_locations;
+        for (const auto& l : order) {
+            if (not rename.contains(l)) continue;
+            const auto& loc = _locations.at(l);
+            new_locations.push_back(location_t(loc.accept_sets(), rename.at(l), loc.name(), loc.invariant()));
+        }
+
+        edges_t new_edges;
+        for (const auto& l : order) {
+            if (not rename.contains(l)) continue;
+            for (const auto& e : edges_from(l))
+                if (rename.contains(e.to()))
+                    new_edges.push_back(edge_t(rename.at(l), rename.at(e.to()), e.guard(), e.reset(), e.label()));
+        }
+
+        // Pruned edges must not shrink the alphabet, since labels outside the alphabet are treated as delays
+        auto labels = std::move(_labels);
+        *this = TA(_name, _clock_names, new_locations, new_edges, rename.at(_initial), _number_of_accept_sets);
+        _labels = std::move(labels);
+        build_label_index();
+    }
+
     std::map<location_id_t, std::vector<clock_index_t>>
     TA::compute_inactive_clocks() {
         std::map<location_id_t, boost::dynamic_bitset<>> active_clocks;
@@ -177,7 +277,9 @@ namespace monitaal {
 
     std::string TA::clock_name(clock_index_t index) const { return _clock_names.at(index); }
 
-    std::map<location_id_t, std::vector<clock_index_t>> TA::inactive_clocks() const { return _inactive_clocks; };
+    const std::map<location_id_t, std::vector<clock_index_t>>& TA::inactive_clocks() const { return _inactive_clocks; };
+
+    const std::string& TA::name() const { return _name; }
 
     const location_map_t &TA::locations() const { return _locations; }
 
@@ -185,10 +287,15 @@ namespace monitaal {
 
     clock_index_t TA::number_of_clocks() const { return _number_of_clocks; }
 
-    const std::unordered_set<label_t>& TA::labels() const { return _labels;}
+    uint32_t TA::number_of_accept_sets() const { return _number_of_accept_sets; }
+
+    const label_set_t& TA::labels() const { return _labels;}
+
+    std::optional<uint32_t> TA::label_index(std::string_view label) const { return _label_index.find(label); }
 
     void TA::intersection(const TA &other) {
 
+        auto labels = this->_labels;
         clock_map_t new_clocks;
 
         new_clocks.insert({0, "0"});
@@ -206,25 +313,42 @@ namespace monitaal {
             }
         }
 
+        auto accept_sets = this->_number_of_accept_sets + other._number_of_accept_sets;
+        if (accept_sets > 8 * sizeof(accept_sets_t))
+            throw base_error("Error: The product of ", this->_name, " and ", other._name, " has ", accept_sets,
+                             " acceptance sets, but at most ", 8 * sizeof(accept_sets_t), " are supported");
+
+        auto shift_constraints = [clock_size](const constraints_t& constraints) {
+            constraints_t rtn;
+            for (const auto& c : constraints)
+                rtn.push_back(constraint_t((c._i == 0 ? 0 : c._i + clock_size),
+                                           (c._j == 0 ? 0 : c._j + clock_size), c._bound));
+            return rtn;
+        };
+
+        auto shift_reset = [clock_size](const clocks_t& reset) {
+            clocks_t rtn;
+            for (const auto& r : reset)
+                rtn.push_back(r == 0 ? 0 : r + clock_size);
+            return rtn;
+        };
+
         locations_t new_locations;
-        std::map<std::pair<location_id_t, location_id_t>, std::pair<location_id_t, location_id_t>> new_loc_indir;
+        std::map<std::pair<location_id_t, location_id_t>, location_id_t> new_loc_indir;
         location_id_t tmp_id = 0;
         for (const auto& [id1, loc1] : this->_locations) {
             for (const auto& [id2, loc2] : other.locations()) {
-                new_loc_indir.insert({{loc1.id(), loc2.id()}, {tmp_id, tmp_id+1}});
+                new_loc_indir.insert({{loc1.id(), loc2.id()}, tmp_id});
 
                 constraints_t constr(loc1.invariant());
-                for (const auto& c : loc2.invariant()) {
-                    constr.push_back(constraint_t((c._i == 0 ? 0 : c._i + clock_size),
-                                                  (c._j == 0 ? 0 : c._j + clock_size), c._bound));
-                }
+                for (const auto& c : shift_constraints(loc2.invariant()))
+                    constr.push_back(c);
 
-                location_t new_loc1(false, tmp_id, loc1.name() + '_' + loc2.name() + "_1", constr);
-                location_t new_loc2(loc2.is_accept(), tmp_id+1, loc1.name() + '_' + loc2.name() + "_2", constr);
+                // The acceptance sets of other are placed after the acceptance sets of this
+                accept_sets_t accept = loc1.accept_sets() | (loc2.accept_sets() << this->_number_of_accept_sets);
 
-                new_locations.push_back(new_loc1);
-                new_locations.push_back(new_loc2);
-                tmp_id += 2;
+                new_locations.push_back(location_t(accept, tmp_id, loc1.name() + '_' + loc2.name(), constr));
+                ++tmp_id;
             }
         }
 
@@ -233,19 +357,9 @@ namespace monitaal {
             for (const auto& e1 : vec1)
                 // Add loops when label is not in alphabet of other
                 if (not other.labels().contains(e1.label())) {
-                    for (const auto& [l, _] : other.locations()) {
-                        const auto& [from_l1, from_l2] = new_loc_indir.at({e1.from(), l});
-                        const auto& [to_l1, to_l2] = new_loc_indir.at({e1.to(), l});
-                        
-                        edge_t new_e1(from_l1, (this->locations().at(e1.from()).is_accept() 
-                                                ? to_l2 : to_l1), e1.guard(), e1.reset(), e1.label());
-
-                        edge_t new_e2(from_l2, (other.locations().at(l).is_accept() 
-                                                ? to_l1 : to_l2), e1.guard(), e1.reset(), e1.label());
-
-                        new_edges.push_back(new_e1);
-                        new_edges.push_back(new_e2);
-                    }
+                    for (const auto& [l, _] : other.locations())
+                        new_edges.push_back(edge_t(new_loc_indir.at({e1.from(), l}), new_loc_indir.at({e1.to(), l}),
+                                                   e1.guard(), e1.reset(), e1.label()));
                 }
                 else 
                     for (const auto& [_, vec2] : other._forward_edges)
@@ -253,66 +367,38 @@ namespace monitaal {
                             if (not e1.label().compare(e2.label())) {
 
                                 constraints_t guard(e1.guard());
-                                for (const auto& c : e2.guard()) {
-                                    guard.push_back(constraint_t((c._i == 0 ? 0 : c._i + clock_size),
-                                                                (c._j == 0 ? 0 : c._j + clock_size), c._bound));
-                                }
+                                for (const auto& c : shift_constraints(e2.guard()))
+                                    guard.push_back(c);
 
                                 clocks_t reset(e1.reset());
-                                for (const auto& r : e2.reset())
-                                    reset.push_back(r == 0 ? 0 : r + clock_size);
-
-                                const std::string label = e1.label();
-
-                                const auto& [to_l1, to_l2] = new_loc_indir.at({e1.to(), e2.to()});
-                                const auto& [from_l1, from_l2] = new_loc_indir.at({e1.from(), e2.from()});
-
-                                edge_t new_e1(from_l1, (this->locations().at(e1.from()).is_accept() 
-                                                        ? to_l2 : to_l1), guard, reset, label);
+                                for (const auto& r : shift_reset(e2.reset()))
+                                    reset.push_back(r);
 
-                                edge_t new_e2(from_l2, (other.locations().at(e2.from()).is_accept() 
-                                                        ? to_l1 : to_l2), guard, reset, label);
-
-                                new_edges.push_back(new_e1);
-                                new_edges.push_back(new_e2);
+                                new_edges.push_back(edge_t(new_loc_indir.at({e1.from(), e2.from()}),
+                                                           new_loc_indir.at({e1.to(), e2.to()}),
+                                                           guard, reset, e1.label()));
                             }
         
         // Add loops when label is not in alphabet of this
         for (const auto& [_, vec2] : other._forward_edges)
             for (const auto& e2 : vec2)
                 if (not this->labels().contains(e2.label())) {
-                    for (const auto& [l, _] : this->locations()) {
-                        const auto& [from_l1, from_l2] = new_loc_indir.at({l, e2.from()});
-                        const auto& [to_l1, to_l2] = new_loc_indir.at({l, e2.to()});
-
-                        constraints_t guard;
-                        for (const auto& c : e2.guard()) {
-                            guard.push_back(constraint_t((c._i == 0 ? 0 : c._i + clock_size),
-                                                        (c._j == 0 ? 0 : c._j + clock_size), c._bound));
-                        }
-
-                        clocks_t reset;
-                        for (const auto& r : e2.reset())
-                            reset.push_back(r == 0 ? 0 : r + clock_size);
-                        
-                        edge_t new_e1(from_l1, (this->locations().at(l).is_accept() 
-                                                ? to_l2 : to_l1), guard, reset, e2.label());
-
-                        edge_t new_e2(from_l2, (other.locations().at(e2.from()).is_accept() 
-                                                ? to_l1 : to_l2), guard, reset, e2.label());
-
-                        new_edges.push_back(new_e1);
-                        new_edges.push_back(new_e2);
-                    }
+                    for (const auto& [l, _] : this->locations())
+                        new_edges.push_back(edge_t(new_loc_indir.at({l, e2.from()}), new_loc_indir.at({l, e2.to()}),
+                                                   shift_constraints(e2.guard()), shift_reset(e2.reset()), e2.label()));
                 }
 
 
         *this = TA(this->_name + '_' + other._name, new_clocks, new_locations, new_edges,
-                   new_loc_indir[{this->initial_location(), other.initial_location()}].first);
+                   new_loc_indir.at({this->initial_location(), other.initial_location()}), accept_sets);
         
-        // Add labels from other to this
+        // Add labels from other to this (and the labels of this that only appeared on pruned edges)
         auto tmp_labels = other.labels();
         this->_labels.merge(tmp_labels);
+        this->_labels.merge(labels);
+        build_label_index();
+
+        trim();
 
     }
 
@@ -393,7 +479,14 @@ namespace monitaal {
         out << T._name << "\n  Locations: (" << T._locations.at(T._initial).name() << ")\n";
         for (const auto& [_,loc] : T._locations) {
             out << "\n    " << loc.name();
-            if (loc.is_accept()) out << " (accept)";
+            if (loc.is_accept()) {
+                out << " (accept";
+                if (T._number_of_accept_sets > 1) {
+                    for (uint32_t set = 0; set < T._number_of_accept_sets; ++set)
+                        if (loc.is_accept(set)) out << ' ' << set;
+                }
+                out << ')';
+            }
 
             if (!loc.invariant().empty()) {
                 out << " invariant: ";
@@ -24,18 +24,30 @@
 #define MONITAAL_TA_H
 
 #include "types.h"
+#include "PerfectHash.h"
 
 #include <pardibaal/DBM.h>
 #include <map>
+#include <optional>
+#include <string_view>
 #include <unordered_set>
 
 namespace monitaal {
 
     struct location_t {
-        location_t(bool accept, location_id_t id, std::string name, constraints_t invariant);
+        /**
+         * @param accept: The acceptance sets of the location as a bitmask.
+         * A plain (non-generalized) accepting location is simply given by true, i.e. acceptance set 0.
+         */
+        location_t(accept_sets_t accept, location_id_t id, std::string name, constraints_t invariant);
 
+        // True if the location is in at least one acceptance set
         [[nodiscard]] bool is_accept() const;
 
+        [[nodiscard]] bool is_accept(uint32_t set) const;
+
+        [[nodiscard]] accept_sets_t accept_sets() const;
+
         [[nodiscard]] location_id_t id() const;
 
         [[nodiscard]] std::string name() const;
@@ -45,7 +57,7 @@ namespace monitaal {
         [[nodiscard]] Zone invariant_zone(clock_index_t dimension) const;
 
     private:
-        const bool _accept;
+        const accept_sets_t _accept;
         const location_id_t _id;
         const std::string _name;
         const constraints_t _invariant;
@@ -64,7 +76,7 @@ namespace monitaal {
 
         [[nodiscard]] Zone guard_zone(clock_index_t dimension) const;
 
-        [[nodiscard]] label_t label() const;
+        [[nodiscard]] const label_t& label() const;
 
     private:
         const location_id_t _from, _to;
@@ -94,13 +106,36 @@ namespace monitaal {
 
         clock_index_t _number_of_clocks;
 
-        std::unordered_set<label_t> _labels = std::unordered_set<label_t>();
+        uint32_t _number_of_accept_sets;
+
+        label_set_t _labels = label_set_t();
+
+        PerfectHash _label_index; // Over _labels
+
+        void build_label_index();
 
         void print_constraint(std::ostream& out, const constraints_t& constraints) const;
 
+        void build_edge_maps(const locations_t &locations, const edges_t &edges);
+
     public:
 
-        TA(std::string name, clock_map_t clocks, const locations_t &locations, const edges_t &edges, location_id_t initial);
+        /**
+         * Constructs a timed (generalized) Büchi automaton. A run is accepting if it visits each of the
+         * number_of_accept_sets acceptance sets infinitely often.
+         */
+        TA(std::string name, clock_map_t clocks, const locations_t &locations, const edges_t &edges, location_id_t initial,
+           uint32_t number_of_accept_sets = 1);
+
+        /**
+         * Constructs an automaton where the alphabet and inactive clocks are already known, e.g. when it is loaded
+         * from a compiled model. The alphabet may contain labels that are on no edge.
+         */
+        TA(std::string name, clock_map_t clocks, const locations_t &locations, const edges_t &edges, location_id_t initial,
+           uint32_t number_of_accept_sets, const label_set_t &labels,
+           std::map<location_id_t, std::vector<clock_index_t>> inactive_clocks);
+
+        [[nodiscard]] const std::string& name() const;
 
         [[nodiscard]] const edges_t &edges_to(location_id_t id) const;
 
@@ -108,7 +143,7 @@ namespace monitaal {
 
         [[nodiscard]] std::string clock_name(clock_index_t index) const;
 
-        std::map<location_id_t, std::vector<clock_index_t>> inactive_clocks() const;
+        [[nodiscard]] const std::map<location_id_t, std::vector<clock_index_t>>& inactive_clocks() const;
 
         [[nodiscard]] const location_map_t& locations() const;
 
@@ -116,10 +151,29 @@ namespace monitaal {
 
         [[nodiscard]] clock_index_t number_of_clocks() const;
 
-        [[nodiscard]] const std::unordered_set<label_t>& labels() const;
+        [[nodiscard]] uint32_t number_of_accept_sets() const;
+
+        [[nodiscard]] const label_set_t& labels() const;
 
+        /**
+         * The index of label in the alphabet, in [0, labels().size()), or nothing if the automaton does not observe
+         * label. This is a perfect hash lookup, so unknown labels are rejected after a single comparison.
+         */
+        [[nodiscard]] std::optional<uint32_t> label_index(std::string_view label) const;
+
+        /**
+         * Synchronous product with another automaton. The acceptance sets of other are appended to the acceptance
+         * sets of this, so the product is a generalized Büchi automaton of the same size as the plain product.
+         */
         void intersection (const TA& other);
 
+        /**
+         * Removes locations that are not reachable from the initial location or cannot reach every acceptance set,
+         * together with their edges. The remaining locations are renumbered densely from 0 (the initial location).
+         * The alphabet is left unchanged.
+         */
+        void trim();
+
         std::map<location_id_t, std::vector<clock_index_t>> compute_inactive_clocks();
 
         static TA time_divergence_ta(const std::vector<std::string>& alphabet, bool deterministic);
@@ -0,0 +1,198 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_TIMER_WHEEL_H
+#define MONITAAL_TIMER_WHEEL_H
+
+#include "types.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace monitaal {
+
+    /**
+     * Hierarchical timing wheel of timers over symb_time_t, e.g. the deadlines of many monitors.
+     *
+     * Level l has 64 slots of 64^l time units, and a timer is kept at the level of the highest base 64 digit in which
+     * its time differs from now. Scheduling and cancelling are O(1). Advancing fires the due timers in order of time and
+     * skips empty slots with a bitmap per level, and each timer moves down at most once per level.
+     *
+     * Timers are referred to by the id returned by schedule, which is reused once the timer fires or is cancelled.
+     */
+    template<class T>
+    class TimerWheel {
+        static constexpr unsigned bits = 6;
+        static constexpr unsigned slots = 1u << bits;
+        static constexpr unsigned levels = (std::numeric_limits<symb_time_t>::digits + bits - 1) / bits;
+
+    public:
+        using timer_id_t = uint32_t;
+
+    private:
+        static constexpr timer_id_t none = std::numeric_limits<timer_id_t>::max();
+
+        struct node_t {
+            symb_time_t time;
+            T value;
+            timer_id_t previous, next;
+        };
+
+        std::vector<node_t> _nodes;
+        std::vector<timer_id_t> _free;
+        std::array<std::array<timer_id_t, slots>, levels> _heads;
+        std::array<uint64_t, levels> _occupied{}; // Bit s of level l is set if slot s of level l has timers
+        symb_time_t _now = 0;
+        size_t _size = 0;
+
+        static unsigned digit(uint64_t time, unsigned level) { return (time >> (bits * level)) & (slots - 1); }
+
+        // Timers before now are due now
+        void link(timer_id_t id) {
+            const uint64_t time = std::max(_nodes[id].time, _now);
+            const unsigned level = time == _now ? 0 : (std::bit_width(time ^ _now) - 1) / bits;
+            const unsigned slot = digit(time, level);
+
+            auto& head = _heads[level][slot];
+            _nodes[id].previous = none;
+            _nodes[id].next = head;
+            if (head != none)
+                _nodes[head].previous = id;
+            head = id;
+            _occupied[level] |= uint64_t(1) << slot;
+        }
+
+        void unlink(timer_id_t id, unsigned level, unsigned slot) {
+            auto& node = _nodes[id];
+            if (node.previous != none)
+                _nodes[node.previous].next = node.next;
+            else
+                _heads[level][slot] = node.next;
+            if (node.next != none)
+                _nodes[node.next].previous = node.previous;
+            if (_heads[level][slot] == none)
+                _occupied[level] &= ~(uint64_t(1) << slot);
+        }
+
+        // The level and slot of a linked timer
+        std::pair<unsigned, unsigned> position(timer_id_t id) const {
+            const uint64_t time = std::max(_nodes[id].time, _now);
+            const unsigned level = time == _now ? 0 : (std::bit_width(time ^ _now) - 1) / bits;
+            return {level, digit(time, level)};
+        }
+
+    public:
+        explicit TimerWheel(symb_time_t now = 0) : _now(now) {
+            for (auto& level : _heads)
+                level.fill(none);
+        }
+
+        // Schedules a timer at time. A time before now is due at the next advance
+        timer_id_t schedule(symb_time_t time, T value) {
+            timer_id_t id;
+            if (_free.empty()) {
+                id = static_cast<timer_id_t>(_nodes.size());
+                _nodes.push_back({time, std::move(value), none, none});
+            } else {
+                id = _free.back();
+                _free.pop_back();
+                _nodes[id].time = time;
+                _nodes[id].value = std::move(value);
+            }
+            link(id);
+            ++_size;
+            return id;
+        }
+
+        // Cancels a timer that has not fired
+        void cancel(timer_id_t id) {
+            auto [level, slot] = position(id);
+            unlink(id, level, slot);
+            _free.push_back(id);
+            --_size;
+        }
+
+        /**
+         * Fires the timers at or before time, in order of time, by calling fire(time, value). Timers at equal times
+         * fire in no particular order. fire may schedule and cancel timers, and timers it schedules at or before time
+         * fire in the same advance.
+         */
+        template<class F>
+        void advance(symb_time_t time, F&& fire) {
+            while (true) {
+                unsigned level = 0;
+                while (level < levels && _occupied[level] == 0)
+                    ++level;
+                if (level == levels) {
+                    _now = std::max(_now, time);
+                    return;
+                }
+
+                // The slots of a level are after the digit of now, so the lowest occupied slot has the earliest timers
+                const unsigned slot = std::countr_zero(_occupied[level]);
+                const uint64_t block = uint64_t(_now) >> (bits * (level + 1)) << (bits * (level + 1));
+                const uint64_t start = block | (uint64_t(slot) << (bits * level));
+                if (start > time) {
+                    // Now only moves within the digits below the earliest timer, so the timers keep their slots
+                    _now = std::max(_now, time);
+                    return;
+                }
+                _now = std::max<uint64_t>(_now, start);
+
+                auto& head = _heads[level][slot];
+                if (level == 0) {
+                    // fire may schedule timers in this slot, which are then fired by this loop
+                    while (head != none) {
+                        const timer_id_t id = head;
+                        const symb_time_t due = _nodes[id].time;
+                        T value = std::move(_nodes[id].value);
+                        unlink(id, 0, slot);
+                        _free.push_back(id);
+                        --_size;
+                        fire(due, std::move(value));
+                    }
+                } else {
+                    // Moves the timers of the slot to lower levels, relative to the new now
+                    const timer_id_t first = head;
+                    head = none;
+                    _occupied[level] &= ~(uint64_t(1) << slot);
+                    for (timer_id_t id = first, next; id != none; id = next) {
+                        next = _nodes[id].next;
+                        link(id);
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] symb_time_t now() const { return _now; }
+
+        [[nodiscard]] size_t size() const { return _size; }
+
+        [[nodiscard]] bool empty() const { return _size == 0; }
+    };
+}
+
+#endif //MONITAAL_TIMER_WHEEL_H
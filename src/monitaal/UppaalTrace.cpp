@@ -0,0 +1,371 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "UppaalTrace.h"
+#include "errors.h"
+
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
+#include <regex>
+
+namespace monitaal {
+
+    namespace {
+        // A pull scanner for the parts of JSON that are needed to find the transitions. Values that are not needed
+        // are skipped without being decoded.
+        struct json_scanner_t {
+            const char* data;
+            size_t size;
+            size_t offset;
+
+            [[noreturn]] void fail(const char* what) const {
+                if (offset >= size)
+                    throw base_error("Error: Expected ", what, " at byte ", offset, " of the UPPAAL trace but it ended");
+                throw base_error("Error: Expected ", what, " at byte ", offset, " of the UPPAAL trace but got \"",
+                                 data[offset], "\"");
+            }
+
+            void skip_whitespace() {
+                while (offset < size && (data[offset] == ' ' || data[offset] == '\t' || data[offset] == '\n' ||
+                                         data[offset] == '\r'))
+                    ++offset;
+            }
+
+            [[nodiscard]] char peek() {
+                skip_whitespace();
+                return offset < size ? data[offset] : '\000';
+            }
+
+            void expect(char c, const char* what) {
+                if (peek() != c)
+                    fail(what);
+                ++offset;
+            }
+
+            // Consumes c if it is next
+            bool accept(char c) {
+                if (peek() != c)
+                    return false;
+                ++offset;
+                return true;
+            }
+
+            // The raw contents of a string, escapes are not decoded
+            std::string_view string() {
+                expect('"', "a string");
+                auto begin = offset;
+                while (offset < size && data[offset] != '"')
+                    offset += data[offset] == '\\' ? 2 : 1;
+                if (offset >= size)
+                    fail("the end of a string");
+                return {data + begin, offset++ - begin};
+            }
+
+            double number() {
+                double value;
+                skip_whitespace();
+                auto [end, error] = std::from_chars(data + offset, data + size, value);
+                if (error != std::errc())
+                    fail("a number");
+                offset = end - data;
+                return value;
+            }
+
+            // UPPAAL writes some numbers as strings
+            double number_or_string() {
+                if (peek() != '"')
+                    return number();
+                auto begin = offset;
+                auto text = string();
+                double value;
+                auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+                if (error != std::errc() || end != text.data() + text.size()) {
+                    offset = begin;
+                    fail("a number");
+                }
+                return value;
+            }
+
+            uint32_t index() {
+                auto begin = offset;
+                auto value = number();
+                if (value < 0 || value > std::numeric_limits<uint32_t>::max() || value != std::floor(value)) {
+                    offset = begin;
+                    fail("an index");
+                }
+                return static_cast<uint32_t>(value);
+            }
+
+            void skip_value() {
+                switch (peek()) {
+                    case '"':
+                        string();
+                        return;
+                    case '{':
+                    case '[': {
+                        size_t depth = 0;
+                        do {
+                            if (offset >= size)
+                                fail("the end of an object or array");
+                            auto c = data[offset];
+                            if (c == '"') {
+                                string();
+                                continue;
+                            }
+                            if (c == '{' || c == '[')
+                                ++depth;
+                            else if (c == '}' || c == ']')
+                                --depth;
+                            ++offset;
+                        } while (depth > 0);
+                        return;
+                    }
+                    default: {
+                        auto begin = offset;
+                        while (offset < size && std::string_view(",}] \t\n\r").find(data[offset]) == std::string_view::npos)
+                            ++offset;
+                        if (offset == begin)
+                            fail("a value");
+                    }
+                }
+            }
+
+            // Calls on_member(key) for each member of an object. on_member must consume the value
+            template<class F>
+            void object(F&& on_member) {
+                expect('{', "an object");
+                if (accept('}'))
+                    return;
+                do {
+                    auto key = string();
+                    expect(':', "\":\" after a key");
+                    on_member(key);
+                } while (accept(','));
+                expect('}', "\",\" or \"}\" in an object");
+            }
+
+            // Calls on_element(i) for each element of an array. on_element must consume the element
+            template<class F>
+            void array(F&& on_element) {
+                expect('[', "an array");
+                if (accept(']'))
+                    return;
+                size_t i = 0;
+                do {
+                    on_element(i++);
+                } while (accept(','));
+                expect(']', "\",\" or \"]\" in an array");
+            }
+        };
+
+        std::string strip_comments(const std::string& text) {
+            static const std::regex comments(R"(//[^\n]*|/\*[\s\S]*?\*/)");
+            return std::regex_replace(text, comments, " ");
+        }
+    }
+
+    UppaalTraceReader::UppaalTraceReader(const std::string& model_path, const std::string& trace_path) :
+            _file(trace_path, "UPPAAL trace", true), _data(_file.data()), _size(_file.size()) {
+        pugi::xml_document model;
+        if (not model.load_file(model_path.c_str()))
+            throw base_error("Error: Could not load the model ", model_path);
+        read_model(model);
+        find_transitions();
+    }
+
+    UppaalTraceReader::UppaalTraceReader(const pugi::xml_document& model, const char* data, size_t size) :
+            _data(data), _size(size) {
+        read_model(model);
+        find_transitions();
+    }
+
+    void UppaalTraceReader::read_model(const pugi::xml_document& model) {
+        auto nta = model.child("nta");
+
+        std::map<std::string, pugi::xml_node, std::less<>> templates;
+        for (auto xml_ta = nta.child("template"); not xml_ta.empty(); xml_ta = xml_ta.next_sibling("template"))
+            templates.insert({xml_ta.child("name").text().as_string(), xml_ta});
+
+        auto system = strip_comments(nta.child("system").text().as_string());
+
+        // Processes instantiated from a template, e.g. P = T(1, 2);
+        std::map<std::string, std::string> instances;
+        static const std::regex instance(R"((\w+)\s*=\s*(\w+)\s*\()");
+        for (std::sregex_iterator it(system.begin(), system.end(), instance), end; it != end; ++it)
+            instances.insert({(*it)[1].str(), (*it)[2].str()});
+
+        std::smatch declaration;
+        static const std::regex system_line(R"(\bsystem\b([^;]*);)");
+        if (not std::regex_search(system, declaration, system_line))
+            throw base_error("Error: The model has no system declaration");
+
+        // Processes are separated by ',' or by '<' (priorities)
+        static const std::regex process(R"(\w+)");
+        auto processes = declaration[1].str();
+        for (std::sregex_iterator it(processes.begin(), processes.end(), process), end; it != end; ++it) {
+            auto name = it->str();
+            auto instance_of = instances.find(name);
+            auto xml_ta = templates.find(instance_of == instances.end() ? name : instance_of->second);
+
+            if (xml_ta == templates.end())
+                throw base_error("Error: Process ", name, " in the system declaration is not a template of the model");
+            // A template with parameters in the system declaration is one process per value of the parameters
+            if (instance_of == instances.end() && not std::string(xml_ta->second.child("parameter").text().as_string()).empty())
+                throw base_error("Error: Process ", name,
+                                 " has parameters. Instantiate it in the system declaration, e.g. P = ", name, "(...);");
+
+            auto& edges = _edges.emplace_back();
+            for (auto tran = xml_ta->second.child("transition"); not tran.empty(); tran = tran.next_sibling("transition")) {
+                label_t label;
+                for (auto node = tran.child("label"); not node.empty(); node = node.next_sibling("label"))
+                    if (std::string_view(node.attribute("kind").as_string()) == "synchronisation") {
+                        label = node.text().as_string();
+                        label = label.substr(0, label.length() - 1); // Remove ! or ?
+                        break;
+                    }
+                edges.push_back(_labels.intern(label));
+            }
+        }
+    }
+
+    void UppaalTraceReader::find_transitions() {
+        json_scanner_t in{_data, _size, 0};
+
+        _transitions = npos;
+        in.expect('{', "a JSON object");
+        if (in.accept('}'))
+            return;
+        do {
+            auto key = in.string();
+            in.expect(':', "\":\" after a key");
+            if (key == "transitions") {
+                in.expect('[', "an array of transitions");
+                _transitions = in.accept(']') ? npos : in.offset;
+                return;
+            }
+            in.skip_value();
+        } while (in.accept(','));
+        in.expect('}', "\",\" or \"}\" in an object");
+    }
+
+    size_t UppaalTraceReader::parse(size_t offset, double& time, event_t& event) const {
+        if (offset > _size)
+            return npos;
+
+        json_scanner_t in{_data, _size, offset};
+
+        while (true) {
+            std::optional<label_id_t> label;
+
+            in.object([&](std::string_view key) {
+                if (key == "delay")
+                    time += in.number_or_string();
+                else if (key == "edges")
+                    in.array([&](size_t i) {
+                        if (i != 0) {
+                            in.skip_value();
+                            return;
+                        }
+                        in.object([&](std::string_view edge_key) {
+                            if (edge_key != "parts") {
+                                in.skip_value();
+                                return;
+                            }
+                            in.array([&](size_t) {
+                                std::optional<uint32_t> procnum, eid;
+                                auto begin = in.offset;
+                                in.object([&](std::string_view part_key) {
+                                    if (part_key == "procnum")
+                                        procnum = in.index();
+                                    else if (part_key == "eid")
+                                        eid = in.index();
+                                    else
+                                        in.skip_value();
+                                });
+                                if (not procnum || not eid)
+                                    return;
+                                if (*procnum >= _edges.size() || *eid >= _edges[*procnum].size())
+                                    throw base_error("Error: Edge ", *eid, " of process ", *procnum, " at byte ", begin,
+                                                     " of the UPPAAL trace is not in the model");
+                                auto id = _edges[*procnum][*eid];
+                                if (not label || _labels.label(*label).empty())
+                                    label = id;
+                            });
+                        });
+                    });
+                else
+                    in.skip_value();
+            });
+
+            bool last = not in.accept(',');
+            if (last)
+                in.expect(']', "\",\" or \"]\" after a transition");
+
+            if (label) {
+                if (time < 0 || time >= static_cast<double>(std::numeric_limits<symb_time_t>::max()))
+                    throw base_error("Error: Time ", time, " before byte ", in.offset, " of the UPPAAL trace is out of range");
+                auto t = static_cast<symb_time_t>(std::floor(time));
+                event.time = {t, t};
+                event.id = *label;
+                event.label = _labels.label(*label);
+                event.type = ONCE;
+                // Past the end of the buffer if this is the last transition
+                return last ? _size + 1 : in.offset;
+            }
+            if (last)
+                return npos;
+        }
+    }
+
+    void UppaalTraceReader::set_alphabet(const PerfectHash& alphabet) {
+        auto unobserved = _labels.intern("");
+        for (auto& edges : _edges)
+            for (auto& id : edges)
+                if (not alphabet.contains(_labels.label(id)))
+                    id = unobserved;
+    }
+
+    UppaalTraceReader::iterator::iterator(const UppaalTraceReader* reader, size_t offset) : _reader(reader) {
+        _next = offset == npos ? npos : _reader->parse(offset, _time, _event);
+    }
+
+    UppaalTraceReader::iterator& UppaalTraceReader::iterator::operator++() {
+        _next = _reader->parse(_next, _time, _event);
+        return *this;
+    }
+
+    UppaalTraceReader::iterator UppaalTraceReader::iterator::operator++(int) {
+        auto rtn = *this;
+        ++*this;
+        return rtn;
+    }
+
+    UppaalTraceReader::iterator UppaalTraceReader::begin() const { return {this, _transitions}; }
+
+    UppaalTraceReader::iterator UppaalTraceReader::end() const { return {}; }
+
+    const LabelTable& UppaalTraceReader::labels() const { return _labels; }
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MONITAAL_UPPAAL_TRACE_H
+#define MONITAAL_UPPAAL_TRACE_H
+
+#include "Monitor.h"
+#include "LabelTable.h"
+#include "MappedFile.h"
+#include "PerfectHash.h"
+#include "types.h"
+
+#include <pugixml.hpp>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+/** UPPAAL TRACE
+ *  Reads the JSON simulation traces of UPPAAL (concrete traces saved from the simulator or by verifyta) directly,
+ *  instead of converting them to a text trace first (as benchmark/uctr-to-monpoly.py does).
+ *
+ *  Only the transitions are read, everything else in the document is skipped:
+ *
+ *      { ..., "transitions": [ { "delay": NUMBER, "edges": [ { "parts": [ { "procnum": INT, "eid": INT }, ... ] } ] },
+ *                              ... ], ... }
+ *
+ *  A part is edge eid of process procnum. Processes are numbered in the order of the system declaration of the model
+ *  and edges in the order of the transitions of their template. The label of a part is the channel of the
+ *  synchronisation of its edge (without ! or ?), as in Parser.
+ *
+ *  Each transition with an edge is an event. Its label is the first labelled part of the first edge (the empty label
+ *  if no part is labelled) and its time is the sum of the delays so far, rounded down to an integer.
+ */
+
+namespace monitaal {
+
+    class UppaalTraceReader {
+        MappedFile _file;
+
+        const char* _data;
+        size_t _size;
+
+        LabelTable _labels;
+        std::vector<std::vector<label_id_t>> _edges; // Label id of each edge by process and eid
+
+        size_t _transitions = 0; // Offset of the first transition, or npos if there are none
+
+        void read_model(const pugi::xml_document& model);
+
+        void find_transitions();
+
+        // Parses the transitions from offset until one with an edge. Returns the offset after it, or npos if there are
+        // no more transitions. time is the sum of the delays before offset and is advanced past the transitions.
+        size_t parse(size_t offset, double& time, event_t& event) const;
+
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        class iterator {
+            friend class UppaalTraceReader;
+
+            const UppaalTraceReader* _reader = nullptr;
+            size_t _next = npos;
+            double _time = 0;
+            event_t _event;
+
+            iterator(const UppaalTraceReader* reader, size_t offset);
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = event_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const event_t*;
+            using reference = const event_t&;
+
+            iterator() = default;
+
+            reference operator*() const { return _event; }
+            pointer operator->() const { return &_event; }
+
+            iterator& operator++();
+            iterator operator++(int);
+
+            bool operator==(const iterator& other) const { return _next == other._next; }
+        };
+
+        /**
+         * Loads the model the trace was simulated on and maps the trace read-only.
+         * Throws base_error if either cannot be read, or if the system declaration of the model cannot be resolved.
+         */
+        UppaalTraceReader(const std::string& model_path, const std::string& trace_path);
+
+        /**
+         * Reads a buffer owned by the caller. The buffer must outlive the reader.
+         */
+        UppaalTraceReader(const pugi::xml_document& model, const char* data, size_t size);
+
+        UppaalTraceReader(const UppaalTraceReader&) = delete;
+        UppaalTraceReader& operator=(const UppaalTraceReader&) = delete;
+
+        /**
+         * Labels outside the alphabet are replaced by the empty label (only the time of the event is kept).
+         * The alphabet is resolved against the edges of the model once, so events are filtered for free.
+         */
+        void set_alphabet(const PerfectHash& alphabet);
+
+        iterator begin() const;
+        iterator end() const;
+
+        [[nodiscard]] const LabelTable& labels() const;
+    };
+}
+
+#endif //MONITAAL_UPPAAL_TRACE_H
@@ -421,7 +421,7 @@ namespace monitaal {
 
         return std::all_of(_states.begin(), _states.end(),
                            [&rhs](const std::pair<location_id_t, state_t>& s) {
-            return rhs.at(s.first).equals(s.second); });
+            return rhs.has_state(s.first) && rhs.at(s.first).equals(s.second); });
     }
 
     template<class state_t>
@@ -620,6 +620,9 @@ namespace monitaal {
         _valuation = std::vector<concrete_time_t>(number_of_clocks + 1);
     }
 
+    concrete_state_t::concrete_state_t(location_id_t location, valuation_t valuation) :
+            _location(location), _valuation(std::move(valuation)) {}
+
     void concrete_state_t::set_empty() {
         _valuation[0] = 2;
     }
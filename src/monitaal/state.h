@@ -113,6 +113,7 @@ namespace monitaal {
         void expect_input() {_is_input_mode = true;}
         void expect_output() {_is_input_mode = false;}
         void switch_input_mode() {_is_input_mode = !_is_input_mode;}
+        [[nodiscard]] bool is_input_mode() const {return _is_input_mode;}
 
     private:
         bool _is_input_mode = true; // Starts with an input, then alternates between inputs and outputs
@@ -157,6 +158,7 @@ namespace monitaal {
 
     struct concrete_state_t {
         concrete_state_t(location_id_t location, pardibaal::dim_t number_of_clocks);
+        concrete_state_t(location_id_t location, valuation_t valuation);
 
         void delay(symb_time_t value);
         void delay(interval_t interval);
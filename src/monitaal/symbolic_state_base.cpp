@@ -22,6 +22,8 @@
 
 #include "symbolic_state_base.h"
 
+#include <utility>
+
 namespace monitaal {
 
     symbolic_state_base::symbolic_state_base() : _location(0), _federation() {}
@@ -49,6 +51,10 @@ namespace monitaal {
             _federation.free(x);
     }
 
+    void symbolic_state_base::remove_clock(clock_index_t clock) {
+        _federation.remove_clock(clock);
+    }
+
     void symbolic_state_base::intersection(const symbolic_state_base& state) {
         if (state._location == _location)
             _federation.intersection(state._federation);
@@ -56,6 +62,11 @@ namespace monitaal {
             this->_federation.restrict(0,0, {-1, true});
     }
 
+    void symbolic_state_base::replace(location_id_t location, Federation federation) {
+        _location = location;
+        _federation = std::move(federation);
+    }
+
     void symbolic_state_base::add(const symbolic_state_base& state) {
         if (state.location() == _location)
             _federation.add(state._federation);
@@ -41,6 +41,12 @@ namespace monitaal {
 
         void free(const clocks_t& clocks);
 
+        // Replaces the location and zones, e.g. when restoring a checkpoint. Other clocks of the state are kept
+        void replace(location_id_t location, Federation federation);
+
+        // Removes the dimension of the clock from the zone. Clocks with a higher index are moved one index down.
+        void remove_clock(clock_index_t clock);
+
         void intersection(const symbolic_state_base& state);
 
         void add(const symbolic_state_base& state);
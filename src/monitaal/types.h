@@ -30,6 +30,9 @@
 #include <map>
 #include <type_traits>
 #include <concepts>
+#include <string>
+#include <string_view>
+#include <unordered_set>
 
 namespace monitaal {
 
@@ -42,6 +45,7 @@ namespace monitaal {
     struct testing_state_t;
 
     struct timed_input_t;
+    struct event_t;
     template<class state_t> class Monitor;
 
     using Federation = pardibaal::Federation;
@@ -59,13 +63,22 @@ namespace monitaal {
     using clocks_t      = std::vector<clock_index_t>;
 
     using location_id_t  = uint32_t;
+    using accept_sets_t  = uint64_t; // Bitmask of the acceptance sets a location belongs to
     using location_map_t = std::map<location_id_t, location_t>;
     using locations_t    = std::vector<location_t>;
 
     using edges_t    = std::vector<edge_t>;
     using edge_map_t = std::map<location_id_t, edges_t>;
 
-    using label_t = std::string;
+    using label_t    = std::string;
+    using label_id_t = uint32_t; // Index of an interned label, see LabelTable
+
+    // Hashes labels such that sets of labels can be searched without constructing a std::string
+    struct label_hash_t {
+        using is_transparent = void;
+        size_t operator()(std::string_view label) const { return std::hash<std::string_view>{}(label); }
+    };
+    using label_set_t = std::unordered_set<label_t, label_hash_t, std::equal_to<>>;
 
     using symb_time_t = uint32_t;
     using interval_t = std::pair<symb_time_t, symb_time_t>;
@@ -0,0 +1,172 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE MONITAAL
+
+#include "monitaal/AsyncMonitor.h"
+#include "monitaal/MPSCRing.h"
+#include "monitaal/Parser.h"
+#include "errors.h"
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace monitaal;
+
+BOOST_AUTO_TEST_CASE(mpsc_ring_test1) {
+    MPSCRing<std::pair<int, int>> ring(64);
+    BOOST_CHECK(ring.capacity() == 64);
+
+    const int producers = 4, n = 50000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < n; ++i)
+                ring.push({p, i});
+        });
+
+    // The values of each producer arrive in order
+    std::vector<int> expected(producers, 0);
+    bool in_order = true;
+    std::pair<int, int> value;
+    for (int i = 0; i < producers * n; ++i) {
+        BOOST_REQUIRE(ring.pop(value));
+        in_order = in_order && value.second == expected[value.first]++;
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    BOOST_CHECK(in_order);
+    BOOST_CHECK(not ring.try_pop(value));
+    ring.close();
+    BOOST_CHECK(not ring.push({0, 0}));
+    BOOST_CHECK(not ring.try_push({0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(mpsc_ring_full_test1) {
+    MPSCRing<int> ring(2);
+    BOOST_CHECK(ring.try_push(1));
+    BOOST_CHECK(ring.try_push(2));
+    BOOST_CHECK(not ring.try_push(3));
+
+    int value = 0;
+    BOOST_CHECK(ring.try_pop(value) && value == 1);
+    BOOST_CHECK(ring.try_push(3));
+    BOOST_CHECK(ring.try_pop(value) && value == 2);
+    BOOST_CHECK(ring.try_pop(value) && value == 3);
+    BOOST_CHECK(not ring.try_pop(value));
+}
+
+BOOST_AUTO_TEST_CASE(async_monitor_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    AsyncMonitor<symbolic_state_t> monitor(Interval_monitor(pos, neg));
+    BOOST_CHECK(monitor.label_id("x") == monitor.label_id(""));
+    BOOST_CHECK(monitor.label_id("a") != monitor.label_id("b"));
+
+    // b is too late, and the queue is closed once the verdict is decided
+    auto verdict = monitor.verdict();
+    BOOST_CHECK(monitor.push({{10, 10}, monitor.label_id("a")}));
+    BOOST_CHECK(monitor.push({{20, 20}, monitor.label_id("x")}));
+    BOOST_CHECK(monitor.push({{45, 45}, monitor.label_id("b")}));
+    BOOST_CHECK(verdict.get().verdict == NEGATIVE);
+    BOOST_CHECK(verdict.get().event == 2);
+    BOOST_CHECK(verdict.get().time == interval_t(45, 45));
+
+    // The worker closes the queue after the verdict, so pushing fails instead of dropping events
+    const interned_event_t late{{50, 50}, monitor.label_id("a")};
+    while (monitor.try_push(late))
+        std::this_thread::yield();
+    BOOST_CHECK(not monitor.push(late));
+    BOOST_CHECK(not monitor.try_push(late));
+    monitor.close();
+    BOOST_CHECK(monitor.monitor().status() == NEGATIVE);
+    BOOST_CHECK(monitor.monitor().events() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(async_monitor_producers_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    std::vector<Concrete_monitor> monitors(3, Concrete_monitor(pos, neg));
+    AsyncMonitor<concrete_state_t> async(monitors, 16);
+
+    const int producers = 4, n = 10000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&async]() {
+            const auto label = async.label_id("b");
+            for (int i = 0; i < n; ++i)
+                async.push({{5, 5}, label});
+        });
+    for (auto& thread : threads)
+        thread.join();
+    async.close();
+
+    // Without a, the verdicts are still inconclusive when the queue is closed
+    for (size_t i = 0; i < async.size(); ++i) {
+        auto verdict = async.verdict(i).get();
+        BOOST_CHECK(verdict.verdict == INCONCLUSIVE);
+        BOOST_CHECK(verdict.event == producers * n);
+        BOOST_CHECK(verdict.time == interval_t(5, 5));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(async_monitor_decided_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    // A monitor that is decided before it is queued keeps the subscribers of the caller
+    Interval_monitor decided(pos, neg);
+    size_t calls = 0;
+    decided.subscribe([&calls](const verdict_change_t&) { ++calls; });
+    decided.input(timed_input_t(10, "a"));
+    decided.input(timed_input_t(50, "x"));
+    BOOST_REQUIRE(calls == 1);
+
+    AsyncMonitor<symbolic_state_t> async(decided);
+    BOOST_CHECK(async.verdict().get().verdict == NEGATIVE);
+    async.close();
+
+    auto copy = async.monitor();
+    copy.reset();
+    copy.input(timed_input_t(10, "a"));
+    copy.input(timed_input_t(50, "x"));
+    BOOST_CHECK(calls == 2);
+}
+
+BOOST_AUTO_TEST_CASE(async_monitor_error_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    Interval_monitor late(pos, neg);
+    late.reset_at(100);
+    AsyncMonitor<symbolic_state_t> monitor(late);
+
+    monitor.push({{5, 5}, monitor.label_id("a")});
+    BOOST_CHECK_THROW(monitor.verdict().get(), base_error);
+    BOOST_CHECK_THROW(monitor.close(), base_error);
+}
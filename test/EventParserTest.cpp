@@ -23,8 +23,16 @@
 #define BOOST_TEST_MODULE MONITAAL
 
 #include "monitaal/EventParser.h"
+#include "monitaal/EventMerger.h"
+#include "monitaal/ReorderBuffer.h"
+#include "monitaal/BinaryTrace.h"
+#include "monitaal/PerfectHash.h"
+#include "monitaal/UppaalTrace.h"
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 using namespace monitaal;
@@ -65,4 +73,456 @@ BOOST_AUTO_TEST_CASE(empty_label_test1) {
     BOOST_CHECK(input[1].time.first == 2);
     BOOST_CHECK(input[2].time.first == 3);
     BOOST_CHECK(input[3].time.first == 4);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(mapped_parsing_test1) {
+    std::string trace = "@[0, 10] \ta\n@[5, 10] b @[10, 10] a\n@1 \n@2 b@3 a\n@4b @ 5 a\n\n";
+    std::stringstream stream(trace, std::ios_base::in);
+
+    auto expected = EventParser::parse_input(&stream, 0);
+
+    MappedEventParser parser(trace.data(), trace.size());
+    std::vector<event_t> events(parser.begin(), parser.end());
+
+    BOOST_REQUIRE(events.size() == expected.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        BOOST_CHECK(events[i].time == expected[i].time);
+        BOOST_CHECK(events[i].label == expected[i].label);
+        BOOST_CHECK(parser.labels().label(events[i].id) == expected[i].label);
+    }
+
+    BOOST_CHECK(parser.labels().size() == 3);
+    BOOST_CHECK(events[0].id == events[2].id);
+    BOOST_CHECK(events[3].label == "");
+}
+
+BOOST_AUTO_TEST_CASE(mapped_parsing_file_test1) {
+    std::ifstream file("models/absentBQRinput.txt");
+    auto expected = EventParser::parse_input(&file, 0);
+
+    MappedEventParser parser("models/absentBQRinput.txt");
+
+    size_t i = 0;
+    for (const auto& event : parser) {
+        BOOST_REQUIRE(i < expected.size());
+        BOOST_CHECK(event.time == expected[i].time);
+        BOOST_CHECK(event.label == expected[i].label);
+        ++i;
+    }
+    BOOST_CHECK(i == expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(mapped_parsing_error_test1) {
+    std::string missing_separator = "@1 a 2 b";
+    MappedEventParser parser1(missing_separator.data(), missing_separator.size());
+    auto it = parser1.begin();
+    BOOST_CHECK(it->label == "a");
+    BOOST_CHECK_THROW(++it, base_error);
+
+    std::string bad_interval = "@[1; 2] a";
+    MappedEventParser parser2(bad_interval.data(), bad_interval.size());
+    BOOST_CHECK_THROW(parser2.begin(), base_error);
+
+    std::string empty = " \n ";
+    MappedEventParser parser3(empty.data(), empty.size());
+    BOOST_CHECK(parser3.begin() == parser3.end());
+
+    BOOST_CHECK_THROW(MappedEventParser("models/does_not_exist.txt"), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(stream_parsing_test1) {
+    std::string trace = "@[0, 10] \ta\n@[5, 10] b @[10, 10] a\n@1 \n@2 b@3 a\n@4b @ 5 a\n\n";
+    std::stringstream expected_stream(trace, std::ios_base::in), stream(trace, std::ios_base::in);
+
+    auto expected = EventParser::parse_input(&expected_stream, 0);
+
+    StreamEventParser parser(stream);
+    size_t i = 0;
+    for (const auto& event : parser) {
+        BOOST_REQUIRE(i < expected.size());
+        BOOST_CHECK(event.time == expected[i].time);
+        BOOST_CHECK(event.label == expected[i].label);
+        ++i;
+    }
+    BOOST_CHECK(i == expected.size());
+    BOOST_CHECK(parser.labels().size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(binary_trace_test1) {
+    std::string trace = "@[0, 10] a\n@[5, 10] b @[10, 10] a\n@1 \n@2 b@3 a\n@[4, 1000000] b @4000000000 a\n";
+    MappedEventParser parser(trace.data(), trace.size());
+    std::vector<event_t> expected(parser.begin(), parser.end());
+
+    std::stringstream binary;
+    BinaryTraceWriter writer(binary, parser.labels());
+    for (auto event : expected) {
+        event.type = event.label == "b" ? OPTIONAL : ONCE;
+        writer.write(event);
+    }
+
+    auto data = binary.str();
+    BinaryTraceReader reader(data.data(), data.size());
+    std::vector<event_t> events(reader.begin(), reader.end());
+
+    BOOST_REQUIRE(events.size() == expected.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        BOOST_CHECK(events[i].time == expected[i].time);
+        BOOST_CHECK(events[i].label == expected[i].label);
+        BOOST_CHECK(events[i].id == expected[i].id);
+        BOOST_CHECK(events[i].type == (expected[i].label == "b" ? OPTIONAL : ONCE));
+    }
+
+    // Truncating the last event and corrupting the magic are reported
+    BinaryTraceReader truncated(data.data(), data.size() - 1);
+    auto it = truncated.begin();
+    for (size_t i = 0; i + 2 < expected.size(); ++i)
+        ++it;
+    BOOST_CHECK_THROW(++it, base_error);
+
+    data[0] = 'X';
+    BOOST_CHECK_THROW(BinaryTraceReader(data.data(), data.size()), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(binary_trace_convert_test1) {
+    auto binary_path = (std::filesystem::temp_directory_path() / "absentBQRinput.mttr").string();
+
+    auto converted = BinaryTraceWriter::convert("models/absentBQRinput.txt", binary_path);
+
+    BOOST_CHECK(BinaryTraceReader::is_binary_trace(binary_path));
+    BOOST_CHECK(not BinaryTraceReader::is_binary_trace("models/absentBQRinput.txt"));
+
+    MappedEventParser text("models/absentBQRinput.txt");
+    BinaryTraceReader binary(binary_path);
+
+    size_t events = 0;
+    auto it = binary.begin();
+    for (const auto& event : text) {
+        BOOST_REQUIRE(it != binary.end());
+        BOOST_CHECK(it->time == event.time);
+        BOOST_CHECK(it->label == event.label);
+        ++it;
+        ++events;
+    }
+    BOOST_CHECK(it == binary.end());
+    BOOST_CHECK(events == converted);
+
+    // Binary traces have no session keys, so a session key before a label is not parsed instead of dropped silently
+    auto sessions_path = (std::filesystem::temp_directory_path() / "sessions.txt").string();
+    std::ofstream(sessions_path) << "@0 #s1 a\n@1 #s2 b\n";
+    BOOST_CHECK_THROW(BinaryTraceWriter::convert(sessions_path, binary_path), base_error);
+
+    // Labels may start with '#'
+    std::ofstream(sessions_path) << "@0 #reset\n@1 a\n";
+    BOOST_CHECK(BinaryTraceWriter::convert(sessions_path, binary_path) == 2);
+    BinaryTraceReader hash_labels(binary_path);
+    std::vector<std::string> labels;
+    for (const auto& event : hash_labels)
+        labels.emplace_back(event.label);
+    BOOST_CHECK(labels == std::vector<std::string>({"#reset", "a"}));
+
+    std::filesystem::remove(sessions_path);
+    std::filesystem::remove(binary_path);
+}
+
+BOOST_AUTO_TEST_CASE(perfect_hash_test1) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 500; ++i)
+        keys.push_back("label" + std::to_string(i));
+    keys.push_back("");
+    keys.push_back("label7"); // Duplicates are stored once
+
+    PerfectHash hash(keys);
+    BOOST_CHECK(hash.size() == 501);
+
+    std::vector<bool> used(hash.size(), false);
+    for (const auto& key : keys) {
+        auto index = hash.find(key);
+        BOOST_REQUIRE(index.has_value());
+        BOOST_CHECK(hash.key(*index) == key);
+        used[*index] = true;
+    }
+    BOOST_CHECK(std::all_of(used.begin(), used.end(), [](bool b) { return b; }));
+
+    BOOST_CHECK(not hash.contains("label500"));
+    BOOST_CHECK(not hash.contains("labe"));
+    BOOST_CHECK(not PerfectHash().contains(""));
+}
+
+BOOST_AUTO_TEST_CASE(alphabet_prefilter_test1) {
+    std::string trace = "@0 a @1 noise @[2, 3] b @4 a @5 other";
+    std::vector<std::string> alphabet = {"a", "b"};
+
+    MappedEventParser parser(trace.data(), trace.size());
+    parser.set_alphabet(PerfectHash(alphabet));
+    std::vector<event_t> events(parser.begin(), parser.end());
+
+    BOOST_REQUIRE(events.size() == 5);
+    BOOST_CHECK(events[1].label.empty() && events[4].label.empty());
+    BOOST_CHECK(events[1].id == events[4].id);
+    BOOST_CHECK(events[2].label == "b" && events[2].time == interval_t(2, 3));
+    BOOST_CHECK(not parser.labels().find("noise").has_value());
+
+    std::stringstream stream(trace, std::ios_base::in);
+    StreamEventParser stream_parser(stream);
+    stream_parser.set_alphabet(PerfectHash(alphabet));
+    size_t i = 0;
+    for (const auto& event : stream_parser)
+        BOOST_CHECK(event.label == events[i++].label);
+    BOOST_CHECK(not stream_parser.labels().find("other").has_value());
+
+    std::stringstream binary;
+    MappedEventParser unfiltered(trace.data(), trace.size());
+    std::vector<event_t> all(unfiltered.begin(), unfiltered.end());
+    BinaryTraceWriter writer(binary, unfiltered.labels());
+    for (const auto& event : all)
+        writer.write(event);
+    auto data = binary.str();
+    BinaryTraceReader reader(data.data(), data.size());
+    reader.set_alphabet(PerfectHash(alphabet));
+    i = 0;
+    for (const auto& event : reader)
+        BOOST_CHECK(event.label == events[i++].label);
+    BOOST_CHECK(i == events.size());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_parsing_test1) {
+    std::stringstream trace;
+    for (int i = 0; i < 2000; ++i)
+        trace << "@" << (i % 7 == 0 ? "[" + std::to_string(i) + ", " + std::to_string(i + 2) + "]" : std::to_string(i))
+              << ' ' << static_cast<char>('a' + i % 5) << (i % 3 == 0 ? "\n" : " ");
+    auto data = trace.str();
+
+    MappedEventParser sequential(data.data(), data.size());
+    std::vector<event_t> expected(sequential.begin(), sequential.end());
+
+    ParallelEventParser parser(data.data(), data.size(), 3, 100);
+    BOOST_CHECK(parser.number_of_chunks() > 100);
+    size_t i = 0;
+    for (const auto& event : parser) {
+        BOOST_REQUIRE(i < expected.size());
+        BOOST_CHECK(event.time == expected[i].time);
+        BOOST_CHECK(event.label == expected[i].label);
+        BOOST_CHECK(parser.labels().label(event.id) == event.label);
+        ++i;
+    }
+    BOOST_CHECK(i == expected.size());
+    BOOST_CHECK(parser.labels().size() == 5);
+
+    // Errors are thrown in order, with the same byte offset as the sequential parser
+    auto bad = data;
+    bad.replace(bad.size() / 2, 1, "!");
+    std::string message;
+    try {
+        MappedEventParser bad_sequential(bad.data(), bad.size());
+        for (auto it = bad_sequential.begin(); it != bad_sequential.end(); ++it);
+    } catch (const base_error& e) { message = e.what(); }
+    BOOST_REQUIRE(not message.empty());
+
+    ParallelEventParser bad_parser(bad.data(), bad.size(), 3, 100);
+    size_t before_error = 0;
+    try {
+        for (auto it = bad_parser.begin(); it != bad_parser.end(); ++it)
+            ++before_error;
+        BOOST_CHECK(false);
+    } catch (const base_error& e) {
+        BOOST_CHECK(message == e.what());
+    }
+    BOOST_CHECK(before_error > 0 && before_error < expected.size());
+
+    // Parsing stops at a '\0' as in the sequential parser
+    auto terminated = data.substr(0, 300) + '\000' + data.substr(300);
+    MappedEventParser terminated_sequential(terminated.data(), terminated.size());
+    ParallelEventParser terminated_parser(terminated.data(), terminated.size(), 2, 50);
+    BOOST_CHECK(std::distance(terminated_sequential.begin(), terminated_sequential.end()) ==
+                std::distance(terminated_parser.begin(), terminated_parser.end()));
+
+    std::vector<std::string> alphabet = {"a", "c"};
+    ParallelEventParser filtered(data.data(), data.size(), 2, 64);
+    filtered.set_alphabet(PerfectHash(alphabet));
+    for (const auto& event : filtered)
+        BOOST_CHECK(event.label.empty() || event.label == "a" || event.label == "c");
+    BOOST_CHECK(filtered.labels().size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(uppaal_trace_test1) {
+    const char* model_xml = R"(<?xml version="1.0" encoding="utf-8"?>
+<nta>
+    <template>
+        <name>Receiver</name>
+        <location id="id0"><name>L0</name></location>
+        <init ref="id0"/>
+        <transition><source ref="id0"/><target ref="id0"/><label kind="synchronisation">a?</label></transition>
+        <transition><source ref="id0"/><target ref="id0"/><label kind="synchronisation">b?</label></transition>
+    </template>
+    <template>
+        <name>Sender</name>
+        <location id="id1"><name>L0</name></location>
+        <init ref="id1"/>
+        <transition><source ref="id1"/><target ref="id1"/></transition>
+        <transition><source ref="id1"/><target ref="id1"/><label kind="synchronisation">a!</label></transition>
+        <transition><source ref="id1"/><target ref="id1"/><label kind="guard">x &gt; 1</label><label kind="synchronisation">b!</label></transition>
+    </template>
+    <system>// Receiver is instantiated
+R = Receiver();
+system Sender, R;</system>
+</nta>)";
+    pugi::xml_document model;
+    BOOST_REQUIRE(model.load_string(model_xml));
+
+    std::string trace = R"({"locations": [["L0"], ["L0"]], "variables": {"x": [0, {"nested": [1, 2]}]},
+        "transitions": [
+            {"delay": 1.5, "edges": [{"parts": [{"procnum": 0, "eid": 1}, {"procnum": 1, "eid": 0}], "id": "a"}]},
+            {"delay": "0.75"},
+            {"delay": 0, "edges": [{"parts": [{"procnum": 0, "eid": 0}]}]},
+            {"edges": [{"parts": [{"procnum": 1, "eid": 1}, {"procnum": 0, "eid": 2}]}], "delay": 10}
+        ], "end": true})";
+
+    UppaalTraceReader reader(model, trace.data(), trace.size());
+    std::vector<event_t> events(reader.begin(), reader.end());
+
+    BOOST_REQUIRE(events.size() == 3);
+    BOOST_CHECK(events[0].label == "a" && events[0].time == interval_t(1, 1));
+    BOOST_CHECK(events[1].label.empty() && events[1].time == interval_t(2, 2));
+    BOOST_CHECK(events[2].label == "b" && events[2].time == interval_t(12, 12));
+    BOOST_CHECK(reader.labels().label(events[2].id) == "b");
+
+    std::vector<std::string> alphabet = {"b"};
+    UppaalTraceReader filtered(model, trace.data(), trace.size());
+    filtered.set_alphabet(PerfectHash(alphabet));
+    std::vector<event_t> filtered_events(filtered.begin(), filtered.end());
+    BOOST_REQUIRE(filtered_events.size() == 3);
+    BOOST_CHECK(filtered_events[0].label.empty() && filtered_events[2].label == "b");
+
+    std::string no_transitions = R"({"locations": []})";
+    UppaalTraceReader empty(model, no_transitions.data(), no_transitions.size());
+    BOOST_CHECK(empty.begin() == empty.end());
+
+    std::string unknown_edge = R"({"transitions": [{"delay": 1, "edges": [{"parts": [{"procnum": 0, "eid": 7}]}]}]})";
+    UppaalTraceReader bad_edge(model, unknown_edge.data(), unknown_edge.size());
+    BOOST_CHECK_THROW(bad_edge.begin(), base_error);
+
+    std::string truncated = R"({"transitions": [{"delay": 1, "edges": [{"parts": [{"procnum": 0, "eid": 1}]}]}, {"del)";
+    UppaalTraceReader bad_json(model, truncated.data(), truncated.size());
+    auto it = bad_json.begin();
+    BOOST_CHECK(it->label == "a");
+    BOOST_CHECK_THROW(++it, base_error);
+
+    pugi::xml_document parameterised;
+    std::string parameterised_xml = model_xml;
+    parameterised_xml.replace(parameterised_xml.find("<name>Sender</name>"), 19,
+                              "<name>Sender</name><parameter>int id</parameter>");
+    BOOST_REQUIRE(parameterised.load_string(parameterised_xml.c_str()));
+    BOOST_CHECK_THROW(UppaalTraceReader(parameterised, trace.data(), trace.size()), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(event_merger_test1) {
+    std::string clutch = "@1 open @5 close @9 open";
+    std::string gearbox = "@[2, 4] neutral @5 set @12 neutral";
+    std::string engine = "@0 torque @5 open";
+
+    MappedEventParser clutch_events(clutch.data(), clutch.size());
+    MappedEventParser gearbox_events(gearbox.data(), gearbox.size());
+    EventMerger merger;
+    merger.add(clutch_events, "clutch");
+    merger.add(gearbox_events, "gearbox");
+    merger.add(std::make_shared<MappedEventParser>(engine.data(), engine.size()), "engine");
+    BOOST_CHECK(merger.number_of_sources() == 3);
+
+    std::vector<std::string> merged;
+    symb_time_t previous = 0;
+    for (const auto& event : merger) {
+        BOOST_CHECK(event.time.first >= previous);
+        BOOST_CHECK(merger.labels().label(event.id) == event.label);
+        previous = event.time.first;
+        merged.emplace_back(event.label);
+    }
+    std::vector<std::string> expected = {"torque", "open", "neutral", "close", "set", "open", "open", "neutral"};
+    BOOST_CHECK(merged == expected);
+    BOOST_CHECK(merger.labels().size() == 5);
+
+    // Events at time 5 are taken from engine, then gearbox, then clutch
+    MappedEventParser clutch2(clutch.data(), clutch.size()), gearbox2(gearbox.data(), gearbox.size()),
+                      engine2(engine.data(), engine.size());
+    EventMerger tie_break;
+    tie_break.add(clutch2);
+    tie_break.add(gearbox2);
+    tie_break.add(engine2);
+    tie_break.set_tie_break({2, 1});
+    merged.clear();
+    for (const auto& event : tie_break)
+        merged.emplace_back(event.label);
+    expected = {"torque", "open", "neutral", "open", "set", "close", "open", "neutral"};
+    BOOST_CHECK(merged == expected);
+
+    std::string unordered = "@1 a @3 b @2 c";
+    MappedEventParser unordered_events(unordered.data(), unordered.size());
+    MappedEventParser engine3(engine.data(), engine.size());
+    EventMerger bad;
+    bad.add(unordered_events, "unordered");
+    bad.add(engine3);
+    BOOST_CHECK_THROW(for (auto it = bad.begin(); it != bad.end(); ++it);, base_error);
+
+    EventMerger bad_tie_break;
+    MappedEventParser engine4(engine.data(), engine.size());
+    bad_tie_break.add(engine4);
+    BOOST_CHECK_THROW(bad_tie_break.set_tie_break({0, 0}), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(event_merger_sessions_test1) {
+    // A stream parser reuses its buffers when it advances, which the merger does before the event is taken
+    std::stringstream first("@1 #s1 a @3 #s2 b @5 #s3 c"), second("@2 #s4 d @4 #s5 e");
+    auto first_events = std::make_shared<StreamEventParser>(first), second_events = std::make_shared<StreamEventParser>(second);
+    first_events->set_sessions(true);
+    second_events->set_sessions(true);
+
+    EventMerger merger;
+    merger.add(first_events);
+    merger.add(second_events);
+
+    std::vector<std::pair<std::string, std::string>> merged;
+    for (const auto& event : merger)
+        merged.emplace_back(event.session, event.label);
+    std::vector<std::pair<std::string, std::string>> expected = {{"s1", "a"}, {"s4", "d"}, {"s2", "b"}, {"s5", "e"},
+                                                                 {"s3", "c"}};
+    BOOST_CHECK(merged == expected);
+}
+
+BOOST_AUTO_TEST_CASE(reorder_buffer_test1) {
+    std::string trace = "@1 a @3 b @2 c @3 d @7 e @5 f @12 g @4 h @13 i";
+
+    // Events more than 5 time units out of order are late
+    std::stringstream stream(trace);
+    StreamEventParser parser(stream);
+    ReorderBuffer by_time(parser, {5, 0});
+    std::vector<event_t> late;
+    by_time.set_late_handler([&late](const event_t& event) { late.push_back(event); });
+
+    std::vector<std::string> sorted;
+    for (const auto& event : by_time) {
+        BOOST_CHECK(by_time.labels().label(event.id) == event.label);
+        sorted.emplace_back(event.label);
+    }
+    std::vector<std::string> expected = {"a", "c", "b", "d", "f", "e", "g", "i"};
+    BOOST_CHECK(sorted == expected);
+    BOOST_CHECK(by_time.late_events() == 1);
+    BOOST_REQUIRE(late.size() == 1);
+    BOOST_CHECK(late[0].time.first == 4);
+
+    // At most two events are held
+    ReorderBuffer by_count(std::make_shared<MappedEventParser>(trace.data(), trace.size()), {std::nullopt, 2});
+    by_count.set_late_handler([](const event_t&) {});
+    sorted.clear();
+    for (const auto& event : by_count)
+        sorted.emplace_back(event.label);
+    expected = {"a", "c", "b", "d", "f", "e", "g", "i"};
+    BOOST_CHECK(sorted == expected);
+    BOOST_CHECK(by_count.late_events() == 1);
+
+    // Without a handler late events are errors
+    MappedEventParser events(trace.data(), trace.size());
+    ReorderBuffer strict(events, {2, 0});
+    BOOST_CHECK_THROW(for (auto it = strict.begin(); it != strict.end(); ++it);, base_error);
+
+    MappedEventParser no_window(trace.data(), trace.size());
+    BOOST_CHECK_THROW(ReorderBuffer(no_window, {}), base_error);
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of monitaal
+ *
+ * monitaal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * monitaal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with monitaal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE MONITAAL
+
+#include "monitaal/ModelArtifact.h"
+#include "monitaal/Monitor.h"
+#include "monitaal/Parser.h"
+#include "monitaal/EventParser.h"
+#include "monitaal/BinaryIO.h"
+#include "errors.h"
+
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+
+using namespace monitaal;
+
+ModelArtifact round_trip(const ModelArtifact& artifact) {
+    std::stringstream stream;
+    artifact.write(stream);
+    auto data = stream.str();
+    return ModelArtifact::decode(data.data(), data.size());
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_test1) {
+    ModelArtifact artifact(Parser::parse_file("models/absentBQR.xml", "positive"),
+                           Parser::parse_file("models/absentBQR.xml", "negative"), false);
+    auto loaded = round_trip(artifact);
+
+    BOOST_CHECK(not loaded.time_divergence());
+    for (const auto& [T, L] : {std::pair{&artifact.positive(), &loaded.positive()},
+                               std::pair{&artifact.negative(), &loaded.negative()}}) {
+        BOOST_CHECK(T->name() == L->name());
+        BOOST_CHECK(T->number_of_clocks() == L->number_of_clocks());
+        BOOST_CHECK(T->initial_location() == L->initial_location());
+        BOOST_CHECK(T->locations().size() == L->locations().size());
+        BOOST_CHECK(T->labels() == L->labels());
+        BOOST_CHECK(T->inactive_clocks() == L->inactive_clocks());
+        for (const auto& [id, loc] : T->locations())
+            BOOST_CHECK(T->edges_from(id).size() == L->edges_from(id).size());
+    }
+
+    BOOST_CHECK(artifact.positive_accepting_space().equals(loaded.positive_accepting_space()));
+    BOOST_CHECK(artifact.negative_accepting_space().equals(loaded.negative_accepting_space()));
+}
+
+BOOST_AUTO_TEST_CASE(monitor_test1) {
+    TA pos = Parser::parse_file("models/absentBQR.xml", "positive");
+    TA neg = Parser::parse_file("models/absentBQR.xml", "negative");
+
+    std::filebuf fb;
+    fb.open("models/absentBQRinput.txt", std::ios::in);
+    std::istream stream(&fb);
+    auto events = EventParser::parse_input(&stream, 0);
+
+    auto path = (std::filesystem::temp_directory_path() / "monitaal_artifact_test.mtal").string();
+    ModelArtifact(pos, neg, false).write(path);
+    auto artifact = ModelArtifact::load(path);
+    std::filesystem::remove(path);
+
+    settings_t setting;
+    Concrete_monitor parsed(pos, neg, setting), compiled(artifact, setting);
+
+    for (const auto& e : events) {
+        parsed.input(e);
+        compiled.input(e);
+        BOOST_CHECK(parsed.status() == compiled.status());
+    }
+    BOOST_CHECK(compiled.status() == NEGATIVE);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_artifact_test1) {
+    ModelArtifact artifact(Parser::parse_file("models/time-must-pass.xml", "positive"),
+                           Parser::parse_file("models/time-must-pass.xml", "negative"), true);
+    BOOST_CHECK(round_trip(artifact).time_divergence());
+
+    std::stringstream stream;
+    artifact.write(stream);
+    auto data = stream.str();
+
+    // Truncated
+    BOOST_CHECK_THROW(ModelArtifact::decode(data.data(), data.size() - 1), base_error);
+
+    // Wrong version
+    auto wrong_version = data;
+    wrong_version[4] = static_cast<char>(ModelArtifact::version + 1);
+    BOOST_CHECK_THROW(ModelArtifact::decode(wrong_version.data(), wrong_version.size()), base_error);
+
+    // Not an artifact
+    std::string xml = "<nta></nta>";
+    BOOST_CHECK_THROW(ModelArtifact::decode(xml.data(), xml.size()), base_error);
+
+    BOOST_CHECK_THROW(ModelArtifact::load("models/does_not_exist.mtal"), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(corrupt_artifact_test1) {
+    // An artifact with one automaton of one clock and one location, whose invariant is written by invariant
+    auto artifact = [](const std::function<void(binary_writer_t&)>& invariant, uint32_t locations) {
+        std::stringstream stream;
+        binary_writer_t w{stream};
+        stream.write("MTAL", 4);
+        w.u32(ModelArtifact::version);
+        w.u32(0);
+        w.string("corrupt");
+        w.u32(1);
+        w.string("x");
+        w.u32(1);
+        w.u32(0);
+        w.u32(locations);
+        w.raw<uint64_t>(1);
+        w.u32(0);
+        w.string("l0");
+        invariant(w);
+        return stream.str();
+    };
+
+    // Clock index 5 of a DBM with 2 clocks
+    auto data = artifact([](binary_writer_t& w) {
+        w.u32(1);
+        w.u32(5);
+        w.u32(0);
+        w.bound(pardibaal::bound_t::non_strict(10));
+    }, 1);
+    BOOST_CHECK_EXCEPTION(ModelArtifact::decode(data.data(), data.size()), base_error, [](const base_error& e) {
+        return std::string(e.what()).find("clock index 5") != std::string::npos;
+    });
+
+    // Counts larger than the file are rejected before allocating
+    data = artifact([](binary_writer_t& w) { w.u32(0xffffffff); }, 1);
+    BOOST_CHECK_THROW(ModelArtifact::decode(data.data(), data.size()), base_error);
+    data = artifact([](binary_writer_t& w) { w.u32(0); }, 0xffffffff);
+    BOOST_CHECK_THROW(ModelArtifact::decode(data.data(), data.size()), base_error);
+}
@@ -28,6 +28,8 @@
 
 #include <boost/test/unit_test.hpp>
 #include <filesystem>
+#include <sstream>
+#include <thread>
 
 using namespace monitaal;
 
@@ -109,6 +111,30 @@ BOOST_AUTO_TEST_CASE(time_divergence_test_1) {
 
 }
 
+BOOST_AUTO_TEST_CASE(time_divergence_test_2) {
+    TA pos = Parser::parse_file("models/time-must-pass.xml", "positive");
+    TA neg = Parser::parse_file("models/time-must-pass.xml", "negative");
+
+    BOOST_CHECK(Fixpoint<symbolic_state_t>::buchi_accept_fixpoint(neg, true).is_empty());
+    BOOST_CHECK(not Fixpoint<symbolic_state_t>::buchi_accept_fixpoint(pos, true).is_empty());
+    BOOST_CHECK(not Fixpoint<symbolic_state_t>::buchi_accept_fixpoint(neg, false).is_empty());
+
+    settings_t setting;
+    setting.time_divergence = true;
+
+    Interval_monitor monitor_int(pos, neg, setting);
+    Concrete_monitor monitor_con(pos, neg, setting);
+
+    BOOST_CHECK(monitor_int.status() == POSITIVE);
+    BOOST_CHECK(not monitor_con.positive_state_estimate().empty());
+    BOOST_CHECK(monitor_con.negative_state_estimate().empty());
+    BOOST_CHECK(monitor_con.status() == POSITIVE);
+
+    // No extra clock in the monitored states
+    for (const auto& s : monitor_int.positive_state_estimate())
+        BOOST_CHECK(s.federation().dimension() == pos.number_of_clocks() + 1);
+}
+
 BOOST_AUTO_TEST_CASE(concrete_state_test1) {
     concrete_state_t s(0, 5);
     symbolic_state_t z1(0, 5);
@@ -145,6 +171,80 @@ BOOST_AUTO_TEST_CASE(absentBQR_test1) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(streaming_input_test1) {
+    TA pos = Parser::parse_file("models/absentBQR.xml", "positive");
+    TA neg = Parser::parse_file("models/absentBQR.xml", "negative");
+
+    std::ifstream file("models/absentBQRinput.txt");
+    StreamEventParser parser(file);
+
+    Concrete_monitor monitor(pos, neg);
+
+    BOOST_CHECK(monitor.input(parser.begin(), parser.end()) == NEGATIVE);
+
+    // The verdict is given by the 10011th event (@10010), nothing after it has been read
+    auto next = parser.begin();
+    BOOST_REQUIRE(next != parser.end());
+    BOOST_CHECK(next->time.first == 10011);
+}
+
+BOOST_AUTO_TEST_CASE(coalesced_input_test1) {
+    for (const std::string name : {"absentBQR", "absentAQ", "absentBR", "recurBQR", "recurGLB"}) {
+        TA pos = Parser::parse_file(("models/" + name + ".xml").c_str(), "positive");
+        TA neg = Parser::parse_file(("models/" + name + ".xml").c_str(), "negative");
+
+        MappedEventParser parser("models/" + name + "input.txt");
+        std::vector<event_t> events(parser.begin(), parser.end());
+
+        Concrete_monitor each(pos, neg), coalesced(pos, neg);
+        Interval_monitor each_int(pos, neg), coalesced_int(pos, neg);
+
+        size_t count = 0;
+        for (const auto& e : events) {
+            ++count;
+            if (each.input(e) != INCONCLUSIVE)
+                break;
+        }
+        BOOST_CHECK(coalesced.input_coalesced(events.begin(), events.end()) == count);
+        BOOST_CHECK(coalesced.status() == each.status());
+
+        count = 0;
+        for (const auto& e : events) {
+            ++count;
+            if (each_int.input(e) != INCONCLUSIVE)
+                break;
+        }
+        BOOST_CHECK(coalesced_int.input_coalesced(events.begin(), events.end()) == count);
+        BOOST_CHECK(coalesced_int.status() == each_int.status());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(coalesced_input_test2) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    // The deadline of a passes in the middle of a run of heartbeats (and d, which is not observed)
+    std::string trace = "@0 a";
+    for (int i = 1; i <= 100; ++i)
+        trace += " @" + std::to_string(i) + (i % 10 == 0 ? " d" : "");
+    MappedEventParser parser(trace.data(), trace.size());
+    std::vector<event_t> events(parser.begin(), parser.end());
+
+    Concrete_monitor each(pos, neg), coalesced(pos, neg);
+    BOOST_CHECK(not coalesced.is_observable("d") && coalesced.is_observable("c"));
+
+    size_t count = 0;
+    for (const auto& e : events) {
+        ++count;
+        if (each.input(e) != INCONCLUSIVE)
+            break;
+    }
+
+    BOOST_CHECK(each.status() == NEGATIVE);
+    BOOST_CHECK(coalesced.input_coalesced(events.begin(), events.end()) == count);
+    BOOST_CHECK(coalesced.status() == NEGATIVE);
+}
+
 BOOST_AUTO_TEST_CASE(absentAQ_test1) {
     TA pos = Parser::parse_file("models/absentAQ.xml", "positive");
     TA neg = Parser::parse_file("models/absentAQ.xml", "negative");
@@ -374,4 +474,399 @@ BOOST_AUTO_TEST_CASE(inactive_clock_test1) {
     //     }
     // }
     // automaton.print_dot(std::cout);
-}
\ No newline at end of file
+}
+BOOST_AUTO_TEST_CASE(trim_test1) {
+    clock_map_t clocks({{0, "0"}, {1, "x"}});
+
+    locations_t locs = {
+        location_t(false, 3, "init", {}),
+        location_t(true, 7, "accept", {}),
+        location_t(false, 8, "dead_end", {}),
+        location_t(true, 9, "unreachable", {})
+    };
+
+    edges_t edges{
+        edge_t(3, 7, {}, {1}, "a"),
+        edge_t(7, 7, {constraint_t::upper_strict(1, 10)}, {}, "a"),
+        edge_t(3, 8, {}, {}, "b"),
+        edge_t(8, 8, {}, {}, "c"),
+        edge_t(9, 3, {}, {}, "d")
+    };
+
+    TA automaton("trim_test", clocks, locs, edges, 3);
+    automaton.trim();
+
+    BOOST_CHECK(automaton.locations().size() == 2);
+    BOOST_CHECK(automaton.initial_location() == 0);
+    BOOST_CHECK(automaton.locations().at(0).name() == "init");
+    BOOST_CHECK(automaton.locations().at(1).name() == "accept");
+    BOOST_CHECK(automaton.edges_from(0).size() == 1);
+    BOOST_CHECK(automaton.edges_from(1).size() == 1);
+
+    // The alphabet is kept, such that pruned labels are still observable
+    BOOST_CHECK(automaton.labels().size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(trim_intersection_test1) {
+    TA pos = Parser::parse_file("models/c_after_10.xml", "positive");
+    TA never_b = Parser::parse_file("models/never_b.xml", "positive");
+
+    auto size = pos.locations().size() * never_b.locations().size();
+    pos.intersection(never_b);
+
+    BOOST_CHECK(pos.locations().size() <= size);
+    BOOST_CHECK(pos.initial_location() == 0);
+    for (const auto& [id, _] : pos.locations())
+        BOOST_CHECK(id < pos.locations().size());
+    BOOST_CHECK(pos.labels().size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(generalized_buchi_test1) {
+    clock_map_t clocks({{0, "0"}, {1, "x"}});
+
+    // Set 0 is {p}, set 1 is {q}. The cycle between p and q visits both sets, and init and s can reach it.
+    locations_t locs = {
+        location_t(0b00, 0, "init", {}),
+        location_t(0b01, 1, "p", {}),
+        location_t(0b10, 2, "q", {}),
+        location_t(0b00, 3, "s", {})
+    };
+
+    edges_t edges{
+        edge_t(0, 1, {}, {}, "a"),
+        edge_t(1, 2, {}, {1}, "a"),
+        edge_t(2, 1, {constraint_t::upper_non_strict(1, 5)}, {}, "a"),
+        edge_t(0, 3, {}, {}, "b"),
+        edge_t(3, 1, {}, {}, "b"),
+        edge_t(1, 3, {}, {}, "b")
+    };
+
+    TA automaton("gba_test", clocks, locs, edges, 0, 2);
+    BOOST_CHECK(automaton.number_of_accept_sets() == 2);
+
+    auto accept = Fixpoint<symbolic_state_t>::buchi_accept_fixpoint(automaton);
+    BOOST_CHECK(accept.has_state(0));
+    BOOST_CHECK(accept.has_state(1));
+    BOOST_CHECK(accept.has_state(2));
+    // s can reach q through p, so s is also accepting
+    BOOST_CHECK(accept.has_state(3));
+
+    // Without the edge back from q, no state visits both sets infinitely often
+    edges_t no_cycle_edges{
+        edge_t(0, 1, {}, {}, "a"),
+        edge_t(1, 2, {}, {1}, "a"),
+        edge_t(0, 3, {}, {}, "b"),
+        edge_t(3, 1, {}, {}, "b"),
+        edge_t(1, 3, {}, {}, "b")
+    };
+    TA no_cycle("gba_test", clocks, locs, no_cycle_edges, 0, 2);
+    BOOST_CHECK(Fixpoint<symbolic_state_t>::buchi_accept_fixpoint(no_cycle).is_empty());
+
+    // The product is the plain synchronous product and keeps both acceptance sets of each operand
+    TA pos = Parser::parse_file("models/time-must-pass.xml", "positive");
+    TA div = TA::time_divergence_ta({"a"}, true);
+    auto size = pos.locations().size() * div.locations().size();
+    pos.intersection(div);
+    BOOST_CHECK(pos.locations().size() <= size);
+    BOOST_CHECK(pos.number_of_accept_sets() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(parse_all_test1) {
+    auto templates = Parser::parse_all_file("models/absentBQR.xml");
+    BOOST_CHECK(templates.size() == 2);
+
+    TA pos = Parser::parse_file("models/absentBQR.xml", "positive");
+    const TA& all_pos = templates.at("positive");
+    BOOST_CHECK(all_pos.locations().size() == pos.locations().size());
+    BOOST_CHECK(all_pos.number_of_clocks() == pos.number_of_clocks());
+    BOOST_CHECK(all_pos.labels() == pos.labels());
+
+    auto properties = Parser::pair_properties(templates);
+    BOOST_CHECK(properties.size() == 1);
+    BOOST_CHECK(properties.at("positive").second.name() == "negative");
+
+    auto only_negative = Parser::parse_all_file("models/absentBQR.xml", {"negative"});
+    BOOST_CHECK(only_negative.size() == 1);
+    BOOST_CHECK(Parser::pair_properties(only_negative).empty());
+
+    BOOST_CHECK_THROW(Parser::parse_all_file("models/absentBQR.xml", {"NotAProperty"}), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(label_index_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA other = Parser::parse_file("models/only_ab_until10.xml", "positive");
+
+    auto check = [](const TA& T) {
+        std::vector<bool> used(T.labels().size(), false);
+        for (const auto& label : T.labels()) {
+            auto index = T.label_index(label);
+            BOOST_REQUIRE(index.has_value() && *index < used.size());
+            BOOST_CHECK(not used[*index]);
+            used[*index] = true;
+        }
+        BOOST_CHECK(not T.label_index("not_a_label").has_value());
+        BOOST_CHECK(not T.label_index("").has_value());
+    };
+
+    check(pos);
+    check(other);
+
+    pos.intersection(other);
+    check(pos);
+}
+
+BOOST_AUTO_TEST_CASE(shared_property_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    auto pos_property = CompiledProperty<symbolic_state_t>::compile(pos, false);
+    auto neg_property = CompiledProperty<symbolic_state_t>::compile(neg, false);
+
+    Interval_monitor monitor1(pos_property, neg_property, settings_t());
+    Interval_monitor monitor2(pos_property, neg_property, settings_t());
+    Concrete_monitor monitor3(pos_property, neg_property, settings_t());
+    BOOST_CHECK(pos_property.use_count() == 4);
+    BOOST_CHECK(monitor1.positive_property() == monitor3.positive_property());
+    BOOST_CHECK(&monitor1.positive_property()->automaton() == &pos_property->automaton());
+
+    // The monitors share the property but not their states
+    monitor1.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(40, "c")});
+    monitor2.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(10, "b")});
+    monitor3.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(40, "c")});
+    BOOST_CHECK(monitor1.status() == NEGATIVE);
+    BOOST_CHECK(monitor2.status() == INCONCLUSIVE);
+    BOOST_CHECK(monitor3.status() == NEGATIVE);
+
+    Interval_monitor copied(pos, neg);
+    copied.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(40, "c")});
+    BOOST_CHECK(copied.status() == NEGATIVE);
+
+    // Monitors of a model artifact share its properties
+    ModelArtifact artifact(pos, neg, false);
+    Interval_monitor artifact_interval(artifact, settings_t());
+    Concrete_monitor artifact_concrete(artifact, settings_t());
+    BOOST_CHECK(artifact_interval.positive_property() == artifact.positive_property());
+    BOOST_CHECK(artifact_concrete.negative_property() == artifact.negative_property());
+}
+
+BOOST_AUTO_TEST_CASE(reset_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    Interval_monitor monitor(pos, neg);
+    Concrete_monitor concrete(pos, neg);
+    auto initial = monitor.positive_state_estimate();
+
+    monitor.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(40, "c")});
+    BOOST_CHECK(monitor.status() == NEGATIVE);
+
+    BOOST_CHECK(monitor.reset() == INCONCLUSIVE);
+    BOOST_CHECK(monitor.positive_state_estimate().size() == initial.size());
+    BOOST_CHECK(monitor.positive_state_estimate()[0].equals(initial[0]));
+    monitor.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(10, "b")});
+    BOOST_CHECK(monitor.status() == INCONCLUSIVE);
+
+    // Time stamps stay absolute after resetting at a later time
+    BOOST_CHECK(monitor.reset_at(100) == INCONCLUSIVE);
+    monitor.input(std::vector<timed_input_t>{timed_input_t(110, "a"), timed_input_t(135, "b")});
+    BOOST_CHECK(monitor.status() == INCONCLUSIVE);
+    monitor.input(std::vector<timed_input_t>{timed_input_t(140, "a"), timed_input_t(180, "c")});
+    BOOST_CHECK(monitor.status() == NEGATIVE);
+
+    concrete.reset_at(100);
+    concrete.input(std::vector<timed_input_t>{timed_input_t(110, "a"), timed_input_t(150, "c")});
+    BOOST_CHECK(concrete.status() == NEGATIVE);
+
+    monitor.reset_at(100);
+    BOOST_CHECK_THROW(monitor.input(timed_input_t(50, "a")), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    auto pos_property = CompiledProperty<symbolic_state_t>::compile(pos, false);
+    auto neg_property = CompiledProperty<symbolic_state_t>::compile(neg, false);
+
+    Interval_monitor monitor(pos_property, neg_property, settings_t());
+    monitor.input(std::vector<timed_input_t>{timed_input_t({0, 5}, "a"), timed_input_t({10, 12}, "b"),
+                                             timed_input_t({15, 20}, "a")});
+
+    std::stringstream checkpoint;
+    monitor.checkpoint(checkpoint, 3);
+    const auto data = checkpoint.str();
+
+    Interval_monitor restored(pos_property, neg_property, settings_t());
+    BOOST_CHECK(restored.restore(data.data(), data.size()) == 3);
+    BOOST_CHECK(restored.status() == INCONCLUSIVE);
+    BOOST_CHECK(restored.positive_state_estimate().size() == monitor.positive_state_estimate().size());
+    BOOST_CHECK(restored.positive_state_estimate()[0].equals(monitor.positive_state_estimate()[0]));
+
+    // The restored monitor continues like the original
+    for (auto* m : {&monitor, &restored}) {
+        m->input(timed_input_t(40, "c"));
+        BOOST_CHECK(m->status() == INCONCLUSIVE);
+        m->input(timed_input_t(51, "c"));
+        BOOST_CHECK(m->status() == NEGATIVE);
+    }
+
+    // A checkpoint of a verdict, written to a file
+    auto path = std::filesystem::temp_directory_path() / "monitaal_checkpoint_test1";
+    restored.checkpoint(path.string(), 5);
+    Interval_monitor from_file(pos_property, neg_property, settings_t());
+    BOOST_CHECK(from_file.restore(path.string()) == 5);
+    BOOST_CHECK(from_file.status() == NEGATIVE);
+    std::filesystem::remove(path);
+
+    // Concrete and delay monitors
+    Concrete_monitor concrete(pos_property, neg_property, settings_t());
+    concrete.input(std::vector<timed_input_t>{timed_input_t(0, "a"), timed_input_t(25, "c")});
+    std::stringstream concrete_checkpoint;
+    concrete.checkpoint(concrete_checkpoint);
+    const auto concrete_data = concrete_checkpoint.str();
+    Concrete_monitor concrete_restored(pos_property, neg_property, settings_t());
+    concrete_restored.restore(concrete_data.data(), concrete_data.size());
+    BOOST_CHECK(concrete_restored.positive_state_estimate()[0].valuation() ==
+                concrete.positive_state_estimate()[0].valuation());
+    concrete_restored.input(timed_input_t(31, "c"));
+    BOOST_CHECK(concrete_restored.status() == NEGATIVE);
+
+    settings_t latency;
+    latency.latency = {0, 5};
+    latency.jitter = 2;
+    Delay_monitor delay(pos, neg, latency);
+    delay.input(timed_input_t(10, "a"));
+    std::stringstream delay_checkpoint;
+    delay.checkpoint(delay_checkpoint);
+    const auto delay_data = delay_checkpoint.str();
+    Delay_monitor delay_restored(pos, neg, latency);
+    delay_restored.restore(delay_data.data(), delay_data.size());
+    BOOST_CHECK(delay_restored.positive_state_estimate()[0].equals(delay.positive_state_estimate()[0]));
+
+    // Checkpoints of other monitors and malformed checkpoints are rejected, and the monitor is unchanged
+    Interval_monitor other(pos_property, neg_property, settings_t());
+    BOOST_CHECK_THROW(other.restore(concrete_data.data(), concrete_data.size()), base_error);
+    BOOST_CHECK_THROW(other.restore(data.data(), data.size() - 1), base_error);
+    Interval_monitor swapped(neg_property, pos_property, settings_t());
+    BOOST_CHECK_THROW(swapped.restore(data.data(), data.size()), base_error);
+    BOOST_CHECK(other.status() == INCONCLUSIVE);
+    BOOST_CHECK(other.positive_state_estimate()[0].equals(Interval_monitor(pos, neg).positive_state_estimate()[0]));
+}
+
+BOOST_AUTO_TEST_CASE(fork_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    Interval_monitor monitor(pos, neg);
+    monitor.input(timed_input_t(10, "a"));
+    const auto estimate = monitor.positive_state_estimate();
+
+    // What if b arrived at time 45 or at time 25?
+    auto late_b = monitor.fork();
+    auto early_b = monitor.fork();
+    BOOST_CHECK(late_b.positive_property() == monitor.positive_property());
+    BOOST_CHECK(late_b.input(timed_input_t(45, "b")) == NEGATIVE);
+    BOOST_CHECK(early_b.input(timed_input_t(25, "b")) == INCONCLUSIVE);
+
+    // The live monitor is unchanged
+    BOOST_CHECK(monitor.status() == INCONCLUSIVE);
+    BOOST_CHECK(monitor.positive_state_estimate().size() == estimate.size());
+    BOOST_CHECK(monitor.positive_state_estimate()[0].equals(estimate[0]));
+    BOOST_CHECK(monitor.input(timed_input_t(35, "b")) == INCONCLUSIVE);
+
+    // Branches evaluated in parallel
+    std::vector<Interval_monitor> branches;
+    for (size_t i = 0; i < 8; ++i)
+        branches.push_back(monitor.fork());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < branches.size(); ++i)
+        threads.emplace_back([&branches, i]() {
+            branches[i].input(timed_input_t(36 + i, "a"));
+            branches[i].input(timed_input_t(60 + 2 * i, "c"));
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < branches.size(); ++i)
+        BOOST_CHECK(branches[i].status() == (i == 7 ? NEGATIVE : INCONCLUSIVE));
+    BOOST_CHECK(monitor.status() == INCONCLUSIVE);
+}
+
+BOOST_AUTO_TEST_CASE(deadline_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    Interval_monitor monitor(pos, neg);
+    Concrete_monitor concrete(pos, neg);
+    BOOST_CHECK(not monitor.deadline());
+    BOOST_CHECK(not concrete.deadline());
+
+    // b must follow within 30 time units, so silence after time 40 is a verdict
+    monitor.input(timed_input_t(10, "a"));
+    concrete.input(timed_input_t(10, "a"));
+    BOOST_REQUIRE(monitor.deadline());
+    BOOST_CHECK(*monitor.deadline() == 41);
+    BOOST_CHECK(concrete.deadline() == monitor.deadline());
+
+    auto silent = monitor.fork();
+    BOOST_CHECK(silent.input(timed_input_t(40, "")) == INCONCLUSIVE);
+    BOOST_CHECK(silent.deadline() == monitor.deadline());
+    BOOST_CHECK(silent.input(timed_input_t(41, "")) == NEGATIVE);
+    BOOST_CHECK(not silent.deadline());
+
+    // With an uncertain time of a, silence decides once it is too long after the latest possible time
+    Interval_monitor uncertain(pos, neg);
+    uncertain.input(timed_input_t({5, 8}, "a"));
+    BOOST_CHECK(uncertain.deadline() == std::optional<symb_time_t>(39));
+
+    BOOST_CHECK(monitor.input(timed_input_t(20, "b")) == INCONCLUSIVE);
+    BOOST_CHECK(not monitor.deadline());
+
+    // Deadlines are absolute after reset_at
+    concrete.reset_at(100);
+    concrete.input(timed_input_t(110, "a"));
+    BOOST_CHECK(concrete.deadline() == std::optional<symb_time_t>(141));
+}
+
+BOOST_AUTO_TEST_CASE(subscribe_test1) {
+    TA pos = Parser::parse_file("models/a-b30.xml", "a_leadsto_b");
+    TA neg = Parser::parse_file("models/a-b30.xml", "not_a_leadsto_b");
+
+    Interval_monitor monitor(pos, neg);
+    std::vector<verdict_change_t> changes;
+    size_t unsubscribed_calls = 0;
+    monitor.subscribe([&changes](const verdict_change_t& change) { changes.push_back(change); });
+    auto unsubscribed = monitor.subscribe([&unsubscribed_calls](const verdict_change_t&) { ++unsubscribed_calls; });
+    monitor.unsubscribe(unsubscribed);
+
+    // A fork does not notify the subscribers of the monitor
+    auto fork = monitor.fork();
+    BOOST_CHECK(fork.input(timed_input_t(10, "a")) == INCONCLUSIVE);
+    BOOST_CHECK(fork.input(timed_input_t(50, "x")) == NEGATIVE);
+    BOOST_CHECK(changes.empty());
+
+    // The unobserved events are coalesced, but the deciding event is still reported
+    std::vector<timed_input_t> word = {
+            timed_input_t(10, "a"),
+            timed_input_t(20, "x"),
+            timed_input_t(30, "x"),
+            timed_input_t(45, "x"),
+            timed_input_t(50, "x")};
+    BOOST_CHECK(monitor.input_coalesced(word.begin(), word.end()) == 4);
+    BOOST_CHECK(monitor.events() == 4);
+    BOOST_REQUIRE(changes.size() == 1);
+    BOOST_CHECK(changes[0].verdict == NEGATIVE);
+    BOOST_CHECK(changes[0].event == 3);
+    BOOST_CHECK(changes[0].time == interval_t(45, 45));
+
+    // Only changes are reported
+    monitor.input(timed_input_t(60, "b"));
+    BOOST_CHECK(changes.size() == 1);
+    BOOST_CHECK(unsubscribed_calls == 0);
+
+    monitor.reset();
+    BOOST_CHECK(monitor.events() == 0);
+    monitor.input(word.begin(), word.end());
+    BOOST_REQUIRE(changes.size() == 2);
+    BOOST_CHECK(changes[1].event == 3);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE MONITAAL
+
+#include "monitaal/SPSCRing.h"
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace monitaal;
+
+BOOST_AUTO_TEST_CASE(ring_order_test1) {
+    SPSCRing<int> ring(3);
+    BOOST_CHECK(ring.capacity() == 4);
+
+    const int n = 100000;
+    std::thread producer([&ring]() {
+        for (int i = 0; i < n; ++i)
+            ring.push(i);
+        ring.close();
+    });
+
+    int expected = 0, value;
+    bool in_order = true;
+    while (ring.pop(value))
+        in_order = in_order && value == expected++;
+    producer.join();
+
+    BOOST_CHECK(in_order);
+    BOOST_CHECK(expected == n);
+}
+
+BOOST_AUTO_TEST_CASE(ring_full_test1) {
+    SPSCRing<int> ring(2);
+    BOOST_CHECK(ring.try_push(1));
+    BOOST_CHECK(ring.try_push(2));
+    BOOST_CHECK(not ring.try_push(3));
+
+    int value = 0;
+    BOOST_CHECK(ring.try_pop(value) && value == 1);
+    BOOST_CHECK(ring.try_push(3));
+
+    // Values pushed before closing are still delivered
+    ring.close();
+    BOOST_CHECK(not ring.push(4));
+    BOOST_CHECK(ring.pop(value) && value == 2);
+    BOOST_CHECK(ring.pop(value) && value == 3);
+    BOOST_CHECK(not ring.pop(value));
+}
+
+BOOST_AUTO_TEST_CASE(ring_early_close_test1) {
+    SPSCRing<int> ring(16);
+
+    int pushed = 0;
+    std::thread producer([&ring, &pushed]() {
+        while (ring.push(pushed))
+            ++pushed;
+    });
+
+    int value = 0;
+    for (int i = 0; i < 100; ++i)
+        BOOST_REQUIRE(ring.pop(value) && value == i);
+    ring.close();
+    producer.join();
+
+    // The producer is stopped by the consumer, at most a full ring ahead
+    BOOST_CHECK(pushed >= 100 && pushed <= 100 + 16);
+}
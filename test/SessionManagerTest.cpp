@@ -0,0 +1,180 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE MONITAAL
+
+#include "monitaal/SessionManager.h"
+#include "monitaal/EventParser.h"
+#include "monitaal/Parser.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
+using namespace monitaal;
+
+namespace {
+    using result_t = std::tuple<std::string, monitor_answer_e, session_end_e>;
+
+    std::vector<result_t> run(const std::string& trace, const session_settings_t& settings,
+                              const char* model = "models/a-b30.xml", const char* positive = "a_leadsto_b",
+                              const char* negative = "not_a_leadsto_b") {
+        auto pos = CompiledProperty<symbolic_state_t>::compile(Parser::parse_file(model, positive), false);
+        auto neg = CompiledProperty<symbolic_state_t>::compile(Parser::parse_file(model, negative), false);
+
+        std::vector<result_t> results;
+        SessionManager<symbolic_state_t> manager(pos, neg, settings_t(), settings,
+                [&results](std::string_view session, monitor_answer_e verdict, session_end_e reason, const auto&) {
+                    results.emplace_back(std::string(session), verdict, reason);
+                });
+
+        MappedEventParser parser(trace.data(), trace.size());
+        parser.set_sessions(true);
+        manager.input(parser.begin(), parser.end());
+        manager.finish();
+        BOOST_CHECK(manager.active_sessions() == 0);
+        return results;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(session_parsing_test1) {
+    std::string trace = "@0 #s1 a @[1, 2] #s2 b\n@3 #s1\n@4 c";
+    MappedEventParser parser(trace.data(), trace.size());
+    parser.set_sessions(true);
+    std::vector<event_t> events(parser.begin(), parser.end());
+
+    BOOST_REQUIRE(events.size() == 4);
+    BOOST_CHECK(events[0].session == "s1" && events[0].label == "a");
+    BOOST_CHECK(events[1].session == "s2" && events[1].label == "b");
+    BOOST_CHECK(events[2].session == "s1" && events[2].label.empty());
+    BOOST_CHECK(events[3].session.empty() && events[3].label == "c");
+
+    std::stringstream stream(trace);
+    StreamEventParser stream_parser(stream);
+    stream_parser.set_sessions(true);
+    size_t i = 0;
+    for (const auto& event : stream_parser) {
+        BOOST_CHECK(event.session == events[i].session);
+        BOOST_CHECK(event.label == events[i].label);
+        ++i;
+    }
+    BOOST_CHECK(i == events.size());
+
+    ParallelEventParser parallel(trace.data(), trace.size(), 2, 8);
+    parallel.set_sessions(true);
+    i = 0;
+    for (const auto& event : parallel) {
+        BOOST_CHECK(event.session == events[i].session);
+        BOOST_CHECK(event.label == events[i].label);
+        ++i;
+    }
+    BOOST_CHECK(i == events.size());
+
+    // Without sessions, '#' is part of the label
+    std::string labels = "@0 #a @1 b";
+    MappedEventParser plain(labels.data(), labels.size());
+    std::vector<event_t> plain_events(plain.begin(), plain.end());
+    BOOST_REQUIRE(plain_events.size() == 2);
+    BOOST_CHECK(plain_events[0].session.empty() && plain_events[0].label == "#a");
+
+    std::stringstream plain_stream(labels);
+    StreamEventParser plain_stream_parser(plain_stream);
+    BOOST_CHECK(plain_stream_parser.begin()->label == "#a");
+}
+
+BOOST_AUTO_TEST_CASE(session_manager_test1) {
+    std::string trace = "@0 #s1 a\n@0 #s2 a\n@5 #s3 a\n@10 #s1 b\n@40 #s2 c\n@50 #s1 a\n";
+
+    auto results = run(trace, session_settings_t());
+    std::vector<result_t> expected = {{"s2", NEGATIVE, VERDICT}, {"s1", INCONCLUSIVE, END}, {"s3", INCONCLUSIVE, END}};
+    std::sort(results.begin() + 1, results.end());
+    BOOST_CHECK(results == expected);
+
+    // s3 and s1 are idle at time 40, and s1 starts again at time 50
+    session_settings_t idle;
+    idle.idle_timeout = 20;
+    results = run(trace, idle);
+    expected = {{"s2", NEGATIVE, VERDICT}, {"s3", INCONCLUSIVE, IDLE}, {"s1", INCONCLUSIVE, IDLE},
+                {"s1", INCONCLUSIVE, END}};
+    BOOST_CHECK(results == expected);
+}
+
+BOOST_AUTO_TEST_CASE(session_manager_shards_test1) {
+    // Many sessions with interleaved events. Sessions with an odd key miss their deadline at time 40 and start again
+    // at time 50
+    std::stringstream trace;
+    for (int t = 0; t < 100; t += 10)
+        for (int s = 0; s < 200; ++s)
+            trace << '@' << t << " #session" << s << (t % 20 == 0 ? " a\n" : (s % 2 == 0 ? " b\n" : " c\n"));
+
+    auto sequential = run(trace.str(), session_settings_t());
+    BOOST_CHECK(sequential.size() == 300);
+    BOOST_CHECK(std::count_if(sequential.begin(), sequential.end(),
+                              [](const result_t& r) { return std::get<1>(r) == NEGATIVE; }) == 100);
+
+    session_settings_t sharded;
+    sharded.shards = 3;
+    sharded.queue_capacity = 16;
+    auto parallel = run(trace.str(), sharded);
+
+    std::sort(sequential.begin(), sequential.end());
+    std::sort(parallel.begin(), parallel.end());
+    BOOST_CHECK(sequential == parallel);
+}
+
+BOOST_AUTO_TEST_CASE(session_manager_deadlines_test1) {
+    // s2 misses its deadline at time 31, which is decided by the event at time 35 of s3. s3 misses its deadline at 131
+    // only after the input ends
+    std::string trace = "@0 #s1 a\n@0 #s2 a\n@10 #s1 b\n@35 #s3 a\n@45 #s3 b\n@100 #s3 a\n";
+
+    session_settings_t deadlines;
+    deadlines.deadlines = true;
+    auto results = run(trace, deadlines);
+    std::vector<result_t> expected = {{"s2", NEGATIVE, DEADLINE}, {"s1", INCONCLUSIVE, END}, {"s3", INCONCLUSIVE, END}};
+    std::sort(results.begin() + 1, results.end());
+    BOOST_CHECK(results == expected);
+
+    // If the shard of s2 has no later event, s2 is decided when the manager is finished
+    deadlines.shards = 2;
+    results = run(trace, deadlines);
+    std::sort(results.begin(), results.end());
+    std::sort(expected.begin(), expected.end());
+    BOOST_CHECK(results == expected);
+
+    std::string unordered = "@10 #s1 a\n@5 #s1 b\n";
+    deadlines.shards = 0;
+    BOOST_CHECK_THROW(run(unordered, deadlines), base_error);
+}
+
+BOOST_AUTO_TEST_CASE(session_manager_start_test1) {
+    // c is only accepted once 10 time units have passed since the session started. s2 starts at time 55, and s1
+    // starts again at time 80 after its verdict
+    std::string trace = "@0 #s1 a\n@55 #s2 c\n@60 #s1 c\n@70 #s2 a\n@80 #s1 c\n";
+
+    auto results = run(trace, session_settings_t(), "models/c_after_10.xml", "positive", "negative");
+    std::vector<result_t> expected = {{"s1", POSITIVE, VERDICT}, {"s1", INCONCLUSIVE, END},
+                                      {"s2", INCONCLUSIVE, END}};
+    std::sort(results.begin() + 1, results.end());
+    BOOST_CHECK(results == expected);
+}
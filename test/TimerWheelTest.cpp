@@ -0,0 +1,130 @@
+/*
+ * Copyright Thomas M. Grosen
+ * Created on 18/10/2026
+ */
+
+/*
+ * This file is part of MoniTAal
+ *
+ * MoniTAal is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * MoniTAal is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with MoniTAal. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE MONITAAL
+
+#include "monitaal/TimerWheel.h"
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace monitaal;
+
+BOOST_AUTO_TEST_CASE(timer_wheel_test1) {
+    TimerWheel<int> wheel(10);
+    std::vector<std::pair<symb_time_t, int>> fired;
+    auto fire = [&fired](symb_time_t time, int value) { fired.emplace_back(time, value); };
+
+    wheel.schedule(15, 1);
+    wheel.schedule(100000, 2);
+    auto cancelled = wheel.schedule(70, 3);
+    wheel.schedule(70, 4);
+    wheel.schedule(5, 5); // Already due
+    wheel.schedule(4000000000u, 6);
+    BOOST_CHECK(wheel.size() == 6);
+
+    wheel.cancel(cancelled);
+    BOOST_CHECK(wheel.size() == 5);
+
+    wheel.advance(14, fire);
+    BOOST_REQUIRE(fired.size() == 1);
+    BOOST_CHECK(fired[0] == std::make_pair(symb_time_t(5), 5));
+    BOOST_CHECK(wheel.now() == 14);
+
+    wheel.advance(99999, fire);
+    BOOST_REQUIRE(fired.size() == 3);
+    BOOST_CHECK(fired[1] == std::make_pair(symb_time_t(15), 1));
+    BOOST_CHECK(fired[2] == std::make_pair(symb_time_t(70), 4));
+
+    wheel.advance(100000, fire);
+    BOOST_CHECK(fired.size() == 4);
+    BOOST_CHECK(wheel.size() == 1);
+
+    wheel.advance(std::numeric_limits<symb_time_t>::max(), fire);
+    BOOST_CHECK(fired.size() == 5);
+    BOOST_CHECK(fired.back().second == 6);
+    BOOST_CHECK(wheel.empty());
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel_reschedule_test1) {
+    // A timer that fires schedules the next one, like a monitor whose deadline moves
+    TimerWheel<int> wheel;
+    std::vector<symb_time_t> fired;
+    wheel.schedule(3, 0);
+    wheel.advance(1000, [&](symb_time_t time, int count) {
+        fired.push_back(time);
+        if (count < 5)
+            wheel.schedule(time + 100 * (count + 1), count + 1);
+    });
+    std::vector<symb_time_t> expected = {3, 103, 303, 603};
+    BOOST_CHECK(fired == expected);
+    BOOST_CHECK(wheel.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel_random_test1) {
+    std::mt19937 random(42);
+    TimerWheel<size_t> wheel;
+    std::multimap<symb_time_t, size_t> expected;
+    std::map<size_t, TimerWheel<size_t>::timer_id_t> ids;
+
+    symb_time_t now = 0;
+    size_t next = 0, fired = 0;
+    bool in_order = true;
+    for (int round = 0; round < 200; ++round) {
+        for (int i = 0; i < 50; ++i) {
+            symb_time_t time = now + random() % (1u << (random() % 24));
+            ids[next] = wheel.schedule(time, next);
+            expected.emplace(time, next++);
+        }
+        for (int i = 0; i < 10 && not ids.empty(); ++i) {
+            auto it = std::next(ids.begin(), random() % ids.size());
+            wheel.cancel(it->second);
+            std::erase_if(expected, [&it](const auto& entry) { return entry.second == it->first; });
+            ids.erase(it);
+        }
+
+        now += random() % 5000;
+        symb_time_t previous = 0;
+        wheel.advance(now, [&](symb_time_t time, size_t value) {
+            auto first = expected.begin();
+            in_order = in_order && time >= previous && first != expected.end() && first->first == time &&
+                       time <= now && ids.erase(value) == 1;
+            previous = time;
+            ++fired;
+            auto range = expected.equal_range(time);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second == value) {
+                    expected.erase(it);
+                    break;
+                }
+        });
+        in_order = in_order && (expected.empty() || expected.begin()->first > now);
+    }
+
+    BOOST_CHECK(in_order);
+    BOOST_CHECK(fired > 1000);
+    BOOST_CHECK(wheel.size() == expected.size());
+}